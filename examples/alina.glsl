@@ -9,8 +9,7 @@ uniform float time;
 uniform vec2 mouse;
 uniform float ration;
 
-uniform sampler1D audioLeft;
-uniform sampler1D audioRight;
+uniform sampler1D audio;
 
 float _clamp(float val, float minimum, float maximum){ return min(max(val, minimum), maximum); }
 float _clamp(float val){ return _clamp(val, 0.0, 1.0); }
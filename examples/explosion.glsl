@@ -6,13 +6,12 @@ uniform float time;
 uniform vec2 mouse;
 uniform float ration;
 
-uniform sampler1D audioLeft;
-uniform sampler1D audioRight;
+uniform sampler1D audio;
 
 out vec4 color;
 
-float left (float val){ return texture(audioLeft , val).r ; }
-float right(float val){ return texture(audioRight, val).r ; }
+float left (float val){ return texture(audio, val).r ; }
+float right(float val){ return texture(audio, val).g ; }
 
 
 // http://glsl.heroku.com/e#13587.0
@@ -9,11 +9,10 @@ uniform float time;
 uniform vec2 mouse;
 uniform float ration;
 
-uniform sampler1D audioLeft;
-uniform sampler1D audioRight;
+uniform sampler1D audio;
 
-float left (float val){ return texture(audioLeft , val).r; }
-float right(float val){ return texture(audioRight, val).r; }
+float left (float val){ return texture(audio, val).r; }
+float right(float val){ return texture(audio, val).g; }
 
 float _clamp(float val, float minimum, float maximum){ return min(max(val, minimum), maximum); }
 float _clamp(float val){ return _clamp(val, 0.0, 1.0); }
@@ -7,10 +7,10 @@ uniform float time;
 uniform vec2 mouse;
 uniform float ration;
 
-uniform sampler1D audioLeft, audioRight;
+uniform sampler1D audio;
 
-float left (float val){ return texture(audioLeft , val).r; }
-float right(float val){ return texture(audioRight, val).r; }
+float left (float val){ return texture(audio, val).r; }
+float right(float val){ return texture(audio, val).g; }
 
 float scale = 4;
 int iter = 10;
@@ -0,0 +1,187 @@
+#include "AudioConverter.hpp"
+
+/**
+ * @brief AudioConverter::AudioConverter
+ * @param format Format of the data that will be converted
+ */
+AudioConverter::AudioConverter(const QAudioFormat &format){
+    setFormat(format);
+}
+
+/**
+ * @brief AudioConverter::setFormat
+ * @param format Format of the data that will be converted
+ *
+ * Select the conversion kernel for format
+ */
+void AudioConverter::setFormat(const QAudioFormat &format){
+    sampleSize = format.sampleSize() / 8;
+    channels = qMax(1, format.channelCount());
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    swapped = format.byteOrder() != QAudioFormat::LittleEndian;
+#else
+    swapped = format.byteOrder() != QAudioFormat::BigEndian;
+#endif
+
+    kind = Unsupported;
+    switch(format.sampleType()){
+        case QAudioFormat::UnSignedInt:
+            if(sampleSize == 1)      kind = UInt8;
+            else if(sampleSize == 2) kind = UInt16;
+            else if(sampleSize == 4) kind = UInt32;
+            break;
+        case QAudioFormat::SignedInt:
+            if(sampleSize == 1)      kind = Int8;
+            else if(sampleSize == 2) kind = Int16;
+            else if(sampleSize == 4) kind = Int32;
+            break;
+        case QAudioFormat::Float:
+            if(sampleSize == 4)      kind = Float;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief AudioConverter::isValid
+ * @return True if the format can be converted
+ */
+bool AudioConverter::isValid() const{
+    return kind != Unsupported;
+}
+
+/**
+ * @brief AudioConverter::frameSize
+ * @return Number of bytes of one input frame
+ */
+int AudioConverter::frameSize() const{
+    return sampleSize * channels;
+}
+
+/**
+ * @brief AudioConverter::convert
+ * @param source Interleaved input frames
+ * @param frames Number of frames to convert
+ * @param target Receives 2 * frames floats, left and right interleaved
+ * @return Number of converted frames
+ */
+int AudioConverter::convert(const char *source, int frames, float *target) const{
+    if(kind == Unsupported || frames <= 0)
+        return 0;
+
+    if(channels == 2){
+        convertSamples(source, frames * 2, target);
+    }else if(channels == 1){
+        // convert into the front half and spread from the back, so nothing is overwritten early
+        convertSamples(source, frames, target);
+        for(int i = frames - 1; i >= 0; --i)
+            target[2*i] = target[2*i+1] = target[i];
+    }else{
+        const int size = frameSize();
+        for(int i = 0; i < frames; ++i, source += size){
+            target[2*i]   = convertSample(source);
+            target[2*i+1] = convertSample(source + sampleSize);
+        }
+    }
+    return frames;
+}
+
+/**
+ * @brief AudioConverter::convertSample
+ * @param source A single input sample
+ * @return The normalized sample
+ *
+ * Scalar conversion that respects the byte order of the format
+ */
+float AudioConverter::convertSample(const char *source) const{
+    const uchar *data = reinterpret_cast<const uchar*>(source);
+    switch(kind){
+        case UInt8:
+            return (data[0] - 128) / 128.f;
+        case Int8:
+            return qint8(data[0]) / 128.f;
+        case UInt16:
+            return ((swapped ? qbswap(qFromUnaligned<quint16>(data)) : qFromUnaligned<quint16>(data)) - 32768) / 32768.f;
+        case Int16:
+            return (swapped ? qbswap(qFromUnaligned<qint16>(data)) : qFromUnaligned<qint16>(data)) / 32768.f;
+        case UInt32:
+            return float((qint64(swapped ? qbswap(qFromUnaligned<quint32>(data)) : qFromUnaligned<quint32>(data)) - 2147483648LL) / 2147483648.0);
+        case Int32:
+            return float((swapped ? qbswap(qFromUnaligned<qint32>(data)) : qFromUnaligned<qint32>(data)) / 2147483648.0);
+        case Float:{
+            quint32 bits = qFromUnaligned<quint32>(data);
+            if(swapped)
+                bits = qbswap(bits);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief AudioConverter::convertSamples
+ * @param source Input samples
+ * @param count Number of samples
+ * @param target Receives count floats
+ *
+ * Convert a contiguous run of samples. Data in native byte
+ * order is converted four samples at a time with SSE2.
+ */
+void AudioConverter::convertSamples(const char *source, int count, float *target) const{
+    int i = 0;
+    if(!swapped){
+        if(kind == Float){
+            memcpy(target, source, count * sizeof(float));
+            return;
+        }
+#ifdef __SSE2__
+        switch(kind){
+            case UInt8: case Int8:{
+                const __m128i bias = _mm_set1_epi8(kind == UInt8 ? char(0x80) : 0);
+                const __m128 scale = _mm_set1_ps(1.f / 128.f);
+                for(; i + 16 <= count; i += 16){
+                    __m128i bytes = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)), bias);
+                    __m128i words[2] = {_mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8),
+                                        _mm_srai_epi16(_mm_unpackhi_epi8(bytes, bytes), 8)};
+                    for(int j = 0; j < 2; ++j){
+                        __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(words[j], words[j]), 16);
+                        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(words[j], words[j]), 16);
+                        _mm_storeu_ps(target + i + 8*j,     _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                        _mm_storeu_ps(target + i + 8*j + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+                    }
+                }
+                break;
+            }
+            case UInt16: case Int16:{
+                const __m128i bias = _mm_set1_epi16(kind == UInt16 ? short(0x8000) : 0);
+                const __m128 scale = _mm_set1_ps(1.f / 32768.f);
+                for(; i + 8 <= count; i += 8){
+                    __m128i words = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2*i)), bias);
+                    __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16);
+                    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(words, words), 16);
+                    _mm_storeu_ps(target + i,     _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                    _mm_storeu_ps(target + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+                }
+                break;
+            }
+            case UInt32: case Int32:{
+                const __m128i bias = _mm_set1_epi32(kind == UInt32 ? int(0x80000000) : 0);
+                const __m128 scale = _mm_set1_ps(1.f / 2147483648.f);
+                for(; i + 4 <= count; i += 4){
+                    __m128i words = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4*i)), bias);
+                    _mm_storeu_ps(target + i, _mm_mul_ps(_mm_cvtepi32_ps(words), scale));
+                }
+                break;
+            }
+            default:
+                break;
+        }
+#endif
+    }
+    for(; i < count; ++i)
+        target[i] = convertSample(source + i * sampleSize);
+}
@@ -0,0 +1,42 @@
+#ifndef AUDIOCONVERTER_HPP
+#define AUDIOCONVERTER_HPP
+
+#include <QAudioFormat>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief The AudioConverter class
+ *
+ * Converts interleaved PCM data of any integer or float
+ * QAudioFormat to interleaved stereo frames of normalized
+ * floats in [-1, 1]. Mono input is copied to both channels,
+ * additional channels are dropped. Native byte order is
+ * converted with SSE2 where available.
+ */
+class AudioConverter
+{
+public:
+    explicit AudioConverter(const QAudioFormat &format = QAudioFormat());
+    void setFormat(const QAudioFormat &);
+    bool isValid() const;
+    int frameSize() const;
+    int convert(const char *, int, float *) const;
+
+private:
+    enum SampleKind{ Unsupported, UInt8, Int8, UInt16, Int16, UInt32, Int32, Float };
+
+    void convertSamples(const char *, int, float *) const;
+    float convertSample(const char *) const;
+
+    SampleKind kind;
+    int sampleSize;
+    int channels;
+    bool swapped;
+};
+
+#endif // AUDIOCONVERTER_HPP
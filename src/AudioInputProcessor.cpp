@@ -1,7 +1,14 @@
 #include "AudioInputProcessor.hpp"
 
+const int AudioInputProcessor::ringFrames = 4096;
+
 AudioInputProcessor::AudioInputProcessor(QObject *parent) :
-    QIODevice(parent)
+    QIODevice(parent),
+    ring(2 * ringFrames, 0.f),
+    ringPosition(0),
+    framesWritten(0),
+    nextAnalysis(0),
+    analysisFrames(2 * ringFrames, 0.f)
 {
     auto inputDevice = QAudioDeviceInfo::defaultInputDevice();
     for(const auto dev : QAudioDeviceInfo::availableDevices(QAudio::AudioInput)){
@@ -30,6 +37,9 @@ AudioInputProcessor::AudioInputProcessor(QObject *parent) :
     }
 
     input = std::unique_ptr<QAudioInput>(new QAudioInput(inputDevice, format, this));
+    converter.setFormat(input->format());
+    if(!converter.isValid())
+        qWarning() << tr("Audio format can not be converted; audio textures stay silent.");
 }
 
 void AudioInputProcessor::start()
@@ -50,11 +60,160 @@ qint64 AudioInputProcessor::readData(char *data, qint64 maxlen)
     return 0;
 }
 
+/**
+ * @brief AudioInputProcessor::readLatest
+ * @param target Receives 2 * frames floats, left and right interleaved
+ * @param frames Number of frames to read; at most ringFrames
+ * @return Number of frames captured so far, to detect new data
+ *
+ * Copy the latest captured frames, oldest first. Thread-safe.
+ */
+quint64 AudioInputProcessor::readLatest(float *target, int frames)
+{
+    frames = qMin(frames, ringFrames);
+    QMutexLocker locker(&ringMutex);
+    int start = (ringPosition - frames + ringFrames) % ringFrames;
+    int first = qMin(frames, ringFrames - start);
+    memcpy(target, ring.data() + 2 * start, 2 * first * sizeof(float));
+    memcpy(target + 2 * first, ring.data(), 2 * (frames - first) * sizeof(float));
+    return framesWritten;
+}
+
+/**
+ * @brief AudioInputProcessor::shared
+ * @return The audio input of all renderers of the process
+ *
+ * Create and start the input for the first caller; it is freed
+ * with the last reference. Must be called on the GUI thread.
+ */
+QSharedPointer<AudioInputProcessor> AudioInputProcessor::shared()
+{
+    static QWeakPointer<AudioInputProcessor> instance;
+    QSharedPointer<AudioInputProcessor> processor = instance.toStrongRef();
+    if(!processor){
+        processor = QSharedPointer<AudioInputProcessor>(new AudioInputProcessor());
+        processor->start();
+        instance = processor;
+    }
+    return processor;
+}
+
+/**
+ * @brief AudioInputProcessor::acquireSpectrum
+ * @param size Number of frames per transform
+ * @param smoothing Weight of the previous spectrum, in [0, 1)
+ * @return Handle of the analysis or -1 if size disables it
+ *
+ * Start a spectrum analysis or share a running one with the
+ * same settings. Every handle must be released with
+ * releaseSpectrum(). Thread-safe.
+ */
+int AudioInputProcessor::acquireSpectrum(int size, float smoothing)
+{
+    QMutexLocker locker(&spectrumMutex);
+    for(auto it = analyses.begin(); it != analyses.end(); ++it)
+        if(it->size == size && it->smoothing == smoothing){
+            ++it->users;
+            return it.key();
+        }
+
+    Analysis analysis;
+    analysis.size = size;
+    analysis.smoothing = smoothing;
+    analysis.users = 1;
+    analysis.analyzer.setSize(qMin(size, ringFrames));
+    analysis.analyzer.setSmoothing(smoothing);
+    if(analysis.analyzer.size() == 0)
+        return -1;
+    analyses.insert(nextAnalysis, analysis);
+    return nextAnalysis++;
+}
+
+/**
+ * @brief AudioInputProcessor::releaseSpectrum
+ * @param handle Handle returned by acquireSpectrum(); -1 is ignored
+ *
+ * Stop the analysis once nobody uses it. Thread-safe.
+ */
+void AudioInputProcessor::releaseSpectrum(int handle)
+{
+    QMutexLocker locker(&spectrumMutex);
+    auto it = analyses.find(handle);
+    if(it != analyses.end() && --it->users <= 0)
+        analyses.erase(it);
+}
+
+/**
+ * @brief AudioInputProcessor::readSpectrum
+ * @param handle Handle returned by acquireSpectrum()
+ * @param left Receives bins magnitudes of the left channel
+ * @param right Receives bins magnitudes of the right channel
+ * @param bins Number of bins to read
+ * @return Number of frames captured when the spectrum was computed
+ *
+ * Copy the latest spectrum of an analysis. Bins the analysis
+ * does not provide are set to zero. Thread-safe.
+ */
+quint64 AudioInputProcessor::readSpectrum(int handle, float *left, float *right, int bins)
+{
+    QMutexLocker locker(&spectrumMutex);
+    auto it = analyses.constFind(handle);
+    int available = 0;
+    quint64 sequence = 0;
+    if(it != analyses.constEnd()){
+        available = qMin(bins, it->analyzer.bins());
+        memcpy(left, it->analyzer.left(), available * sizeof(float));
+        memcpy(right, it->analyzer.right(), available * sizeof(float));
+        sequence = it->sequence;
+    }
+    std::fill(left + available, left + bins, 0.f);
+    std::fill(right + available, right + bins, 0.f);
+    return sequence;
+}
+
+/**
+ * @brief AudioInputProcessor::writeData
+ * @param data Captured audio data
+ * @param len Number of bytes
+ * @return Number of bytes consumed
+ *
+ * Convert the captured frames directly into the ring;
+ * frames that would be overwritten right away are skipped.
+ * Afterwards the spectra of the latest frames are updated;
+ * the frames are read once for all of them.
+ */
 qint64 AudioInputProcessor::writeData(const char *data, qint64 len)
 {
-//    int bufSize = input->bufferSize() / 5;
-//    if(len < bufSize)
-//        return 0;
-    Q_EMIT processData(QByteArray(data, len));
+    const int frameSize = converter.frameSize();
+    if(!converter.isValid() || frameSize <= 0)
+        return len;
+
+    int frames = int(len / frameSize);
+    const int skipped = qMax(0, frames - ringFrames);
+    data += qint64(skipped) * frameSize;
+    frames -= skipped;
+
+    ringMutex.lock();
+    while(frames > 0){
+        int chunk = qMin(frames, ringFrames - ringPosition);
+        converter.convert(data, chunk, ring.data() + 2 * ringPosition);
+        ringPosition = (ringPosition + chunk) % ringFrames;
+        data += qint64(chunk) * frameSize;
+        frames -= chunk;
+    }
+    framesWritten += quint64(len / frameSize);
+    ringMutex.unlock();
+
+    QMutexLocker locker(&spectrumMutex);
+    int size = 0;
+    for(const Analysis &analysis : analyses)
+        size = qMax(size, analysis.analyzer.size());
+    if(size == 0)
+        return len;
+    quint64 sequence = readLatest(analysisFrames.data(), size);
+    for(Analysis &analysis : analyses){
+        analysis.sequence = sequence;
+        analysis.analyzer.analyze(analysisFrames.data() + 2 * (size - analysis.analyzer.size()));
+    }
     return len;
 }
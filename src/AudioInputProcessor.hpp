@@ -1,12 +1,32 @@
 #ifndef AUDIOINPUTPROCESSOR_HPP
 #define AUDIOINPUTPROCESSOR_HPP
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include <QIODevice>
 #include <QDebug>
 #include <QAudioInput>
+#include <QMutex>
+#include <QMap>
+#include <QSharedPointer>
+#include <QWeakPointer>
 
+#include "AudioConverter.hpp"
+#include "SpectrumAnalyzer.hpp"
+
+/**
+ * @brief The AudioInputProcessor class
+ *
+ * A QIODevice that captures the audio input, converts it
+ * to normalized stereo floats and keeps the latest frames
+ * in a preallocated ring that renderers read from. If a
+ * renderer asks for it, the magnitude spectrum of the latest
+ * frames is computed once per captured buffer as well; renderers
+ * that ask for the same analysis share it. All renderers of the
+ * process read from one shared() processor.
+ */
 class AudioInputProcessor : public QIODevice
 {
     Q_OBJECT
@@ -14,13 +34,39 @@ public:
     explicit AudioInputProcessor(QObject *parent = 0);
     void start();
     const QAudioFormat format() const;
-
-Q_SIGNALS:
-    void processData(QByteArray);
-
+    quint64 readLatest(float *, int);
+    int acquireSpectrum(int, float);
+    void releaseSpectrum(int);
+    quint64 readSpectrum(int, float *, float *, int);
+    static QSharedPointer<AudioInputProcessor> shared();
+    static const int ringFrames;
 
 private:
+    /**
+     * @brief The Analysis struct
+     *
+     * A spectrum analysis with the settings it was requested
+     * with and the number of renderers that use it
+     */
+    struct Analysis{
+        Analysis() : size(0), smoothing(0), users(0), sequence(0) { }
+        int size;
+        float smoothing;
+        int users;
+        quint64 sequence;
+        SpectrumAnalyzer analyzer;
+    };
+
     std::unique_ptr<QAudioInput> input;
+    AudioConverter converter;
+    QMutex ringMutex;
+    std::vector<float> ring;
+    int ringPosition;
+    quint64 framesWritten;
+    QMutex spectrumMutex;
+    QMap<int, Analysis> analyses;
+    int nextAnalysis;
+    std::vector<float> analysisFrames;
 //    QMutex dataAccess;
 //    char *data;
 
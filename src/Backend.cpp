@@ -28,7 +28,8 @@ Backend::~Backend(){
     for(auto* thread: threads.values()){
         if(thread){
             if(thread->isRunning())
-                thread->terminate();
+                thread->stop();
+            thread->wait();
             delete thread;
         }
     }
@@ -65,6 +66,8 @@ void Backend::addInstance(IInstance *instance, bool removeSettings){
     connect(instance, SIGNAL(closeAll()), this, SLOT(childSaidCloseAll()));
     connect(instance, SIGNAL(openSettings(IInstance*)), this, SLOT(settingsWindowRequested(IInstance*)));
     connect(instance, SIGNAL(openHelp(IInstance*)), this, SLOT(openHelp(IInstance*)));
+    connect(instance, SIGNAL(changeParameter(IInstance*, QString, float)),
+            this, SLOT(instanceChangedParameter(IInstance*, QString, float)));
     ids.append(id);
     saveIDs();
 }
@@ -236,6 +239,8 @@ QHash<QString, QVariant> Backend::getSettings(int id)
 void Backend::settingsWindowRequested(IInstance *instance){
     SettingsWindow settingsWin(instance->ID);
     settingsWin.exec();
+    if(threads.contains(instance->ID))
+        threads[instance->ID]->applySettings(getSettings(instance));
 }
 
 /**
@@ -409,6 +414,20 @@ void Backend::instanceRequestSettings(IInstance *instance, QHash<QString, QVaria
     set = SettingsBackend::getSettings(instance->ID);
 }
 
+/**
+ * @brief Backend::instanceChangedParameter
+ * @param instance
+ * @param name
+ * @param value
+ *
+ * Hands a uniform value set in an instance to its renderer.
+ */
+void Backend::instanceChangedParameter(IInstance *instance, const QString &name, float value)
+{
+    if(threads.contains(instance->ID))
+        threads[instance->ID]->setParameter(name, value);
+}
+
 /**
  * @brief Backend::runPyFile
  * @param filename
@@ -476,7 +495,12 @@ void Backend::runGlFile(IInstance *instance){
             this, SLOT(getExecutionResults(GlLiveThread*, QString)));
     connect(thread, SIGNAL(errorSignal(GlLiveThread*, QString, int)),
             this, SLOT(getError(GlLiveThread*, QString, int)));
+    connect(thread, SIGNAL(statisticsSignal(GlLiveThread*, FrameStatistics)),
+            this, SLOT(getStatistics(GlLiveThread*, FrameStatistics)));
+    connect(thread, SIGNAL(parametersSignal(GlLiveThread*, QList<ShaderParameter>)),
+            this, SLOT(getParameters(GlLiveThread*, QList<ShaderParameter>)));
     thread->initialize(instance->title(), instance->sourceCode());
+    thread->applySettings(getSettings(instance));
     thread->start();
     threads.insert(thread->ID, thread);
 }
@@ -523,6 +547,30 @@ void Backend::getError(GlLiveThread* thread, QString error, int lineno){
         instances[thread->ID]->highlightErroredLine(lineno);
 }
 
+/**
+ * @brief Backend::getStatistics
+ * @param thread
+ * @param statistics
+ *
+ * Forwards the frame timing of a renderer to its instance.
+ */
+void Backend::getStatistics(GlLiveThread* thread, FrameStatistics statistics){
+    if(instances.contains(thread->ID))
+        instances[thread->ID]->reportFrameStatistics(statistics);
+}
+
+/**
+ * @brief Backend::getParameters
+ * @param thread
+ * @param parameters
+ *
+ * Forwards the annotated uniforms of a renderer to its instance.
+ */
+void Backend::getParameters(GlLiveThread* thread, QList<ShaderParameter> parameters){
+    if(instances.contains(thread->ID))
+        instances[thread->ID]->reportParameters(parameters);
+}
+
 /**
  * @brief Backend::terminateThread
  * @param thread
@@ -532,7 +580,7 @@ void Backend::getError(GlLiveThread* thread, QString error, int lineno){
 void Backend::terminateThread(long id){
     if(threads.contains(id)){
         if(threads[id]->isRunning())
-            threads[id]->terminate();
+            threads[id]->stop();
         threads[id]->wait();
         threads[id]->deleteLater();
         threads.remove(id);
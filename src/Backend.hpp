@@ -61,6 +61,7 @@ public Q_SLOTS:
     void instanceRequestSetting(IInstance *, const QString &key, QVariant &value);
     void instanceChangedSettings(IInstance *, const QHash<QString, QVariant> &);
     void instanceRequestSettings(IInstance *, QHash<QString, QVariant> &);
+    void instanceChangedParameter(IInstance *, const QString &, float);
 //    void instanceRemoveID(IInstance *instance);
     void childSaidCloseAll();
 
@@ -70,6 +71,8 @@ public Q_SLOTS:
     void getExecutionResults(GlLiveThread*, QString);
 
     void getError(GlLiveThread*, QString, int);
+    void getStatistics(GlLiveThread*, FrameStatistics);
+    void getParameters(GlLiveThread*, QList<ShaderParameter>);
 
 private:
     void runPyFile(IInstance *);
@@ -1,5 +1,10 @@
 #include "EditorWindow.hpp"
 
+/**
+ * Number of slider steps between the limits of a float parameter
+ */
+static const int parameterSteps = 1000;
+
 /**
  * @brief EditorWindow::EditorWindow
  *
@@ -18,6 +23,7 @@ EditorWindow::EditorWindow(const QHash<QString, QVariant> &settings, QWidget *pa
     addMenus();
     addToolBars();
     addStatusBar();
+    addParameterDock();
 
     connect(codeEditor->document(), SIGNAL(contentsChanged()), this, SLOT(docModified()));
 
@@ -218,6 +224,140 @@ void EditorWindow::warningDisplay(const QString &message){
 void EditorWindow::codeStopped()
 {
     runAction->setIcon(QIcon(":/images/run.png"));
+    statisticsLabel->clear();
+    statisticsLabel->setToolTip(QString());
+    showParameters(QList<ShaderParameter>());
+}
+
+/**
+ * @brief EditorWindow::showParameters
+ * @param shown Annotated uniforms of the running renderer
+ *
+ * Shows a slider for each annotated uniform in the parameter
+ * dock, which is hidden if there are none. The sliders are only
+ * built anew if the uniforms or their ranges changed, so editing
+ * other code keeps them in place.
+ */
+void EditorWindow::showParameters(const QList<ShaderParameter> &shown){
+    bool same = shown.size() == parameters.size();
+    for(int i = 0; same && i < shown.size(); ++i)
+        same = shown[i].name == parameters[i].name && shown[i].type == parameters[i].type &&
+               shown[i].minimum == parameters[i].minimum && shown[i].maximum == parameters[i].maximum;
+    parameters = shown;
+
+    if(!same){
+        delete parameterDock->widget();
+        parameterSliders.clear();
+        parameterLabels.clear();
+
+        QWidget *controls = new QWidget(parameterDock);
+        QFormLayout *layout = new QFormLayout(controls);
+        for(const ShaderParameter &parameter : parameters){
+            QSlider *slider = new QSlider(Qt::Horizontal, controls);
+            if(parameter.type == ShaderParameter::Int)
+                slider->setRange(int(parameter.minimum), int(parameter.maximum));
+            else
+                slider->setRange(0, parameterSteps);
+            connect(slider, SIGNAL(valueChanged(int)), this, SLOT(parameterMoved(int)));
+
+            QLabel *label = new QLabel(controls);
+            label->setMinimumWidth(label->fontMetrics().width("-0.0000"));
+            QHBoxLayout *row = new QHBoxLayout();
+            row->addWidget(slider);
+            row->addWidget(label);
+            layout->addRow(parameter.name, row);
+
+            parameterSliders.append(slider);
+            parameterLabels.append(label);
+        }
+        parameterDock->setWidget(controls);
+        parameterDock->setVisible(!parameters.isEmpty());
+    }
+
+    for(int i = 0; i < parameters.size(); ++i){
+        const ShaderParameter &parameter = parameters[i];
+        QSlider *slider = parameterSliders[i];
+        slider->blockSignals(true);
+        if(parameter.type == ShaderParameter::Int)
+            slider->setValue(qRound(parameter.value));
+        else
+            slider->setValue(qRound((parameter.value - parameter.minimum) /
+                                    (parameter.maximum - parameter.minimum) * parameterSteps));
+        slider->blockSignals(false);
+        showParameterValue(i);
+    }
+}
+
+/**
+ * @brief EditorWindow::parameterMoved
+ * @param position New position of the slider
+ *
+ * Sets the uniform of a moved slider(SLOT).
+ */
+void EditorWindow::parameterMoved(int position){
+    int index = parameterSliders.indexOf(qobject_cast<QSlider*>(sender()));
+    if(index < 0)
+        return;
+    ShaderParameter &parameter = parameters[index];
+    if(parameter.type == ShaderParameter::Int)
+        parameter.value = position;
+    else
+        parameter.value = parameter.minimum + (parameter.maximum - parameter.minimum) * position / parameterSteps;
+    showParameterValue(index);
+    Q_EMIT changedParameter(this, parameter.name, parameter.value);
+}
+
+/**
+ * @brief EditorWindow::showParameterValue
+ * @param index Index of the parameter
+ *
+ * Shows the value of a parameter beside its slider.
+ */
+void EditorWindow::showParameterValue(int index){
+    const ShaderParameter &parameter = parameters[index];
+    if(parameter.type == ShaderParameter::Int)
+        parameterLabels[index]->setText(QString::number(qRound(parameter.value)));
+    else
+        parameterLabels[index]->setText(QString::number(parameter.value, 'g', 4));
+}
+
+/**
+ * @brief EditorWindow::showFrameStatistics
+ * @param statistics
+ *
+ * Displays the frame timing of the running renderer
+ * permanently in the status bar; the GPU time of each
+ * pass is shown as tool tip. A running recording is
+ * shown with the frames it dropped.
+ */
+void EditorWindow::showFrameStatistics(const FrameStatistics &statistics){
+    const double rate = statistics.interval > 0 ? statistics.frames * 1000.0 / statistics.interval : 0;
+    QString text = tr("%1 fps | %2 ms/frame (max %3) | %4 missed")
+                   .arg(rate, 0, 'f', 1)
+                   .arg(statistics.frameTime, 0, 'f', 1)
+                   .arg(statistics.maxFrameTime, 0, 'f', 1)
+                   .arg(statistics.missedDeadlines);
+    if(statistics.resolutionScale < 1)
+        text += tr(" | %1% resolution").arg(qRound(statistics.resolutionScale * 100));
+    text += tr(" | CPU %1 ms (p95 %2)")
+            .arg(statistics.cpuTime, 0, 'f', 2)
+            .arg(statistics.cpuTimeP95, 0, 'f', 2);
+
+    QString passes;
+    if(statistics.gpuFrames > 0){
+        text += tr(" | GPU %1 ms (p95 %2, p99 %3)")
+                .arg(statistics.gpuTime, 0, 'f', 2)
+                .arg(statistics.gpuTimeP95, 0, 'f', 2)
+                .arg(statistics.gpuTimeP99, 0, 'f', 2);
+        for(int i = 0; i < statistics.passTimes.size() && i < statistics.passNames.size(); ++i)
+            if(statistics.passTimes[i] > 0)
+                passes += tr("%1: %2 ms\n").arg(statistics.passNames[i])
+                          .arg(statistics.passTimes[i], 0, 'f', 2);
+    }
+    if(statistics.recording)
+        text += tr(" | recording, %1 dropped").arg(statistics.droppedFrames);
+    statisticsLabel->setText(text);
+    statisticsLabel->setToolTip(passes.trimmed());
 }
 
 /**
@@ -392,9 +532,25 @@ void EditorWindow::addToolBars(){
  * message in it displaying it is ready to use.
  */
 void EditorWindow::addStatusBar(){
+    statisticsLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(statisticsLabel);
     statusBar()->showMessage(tr("Ready"));
 }
 
+/**
+ * @brief EditorWindow::addParameterDock
+ *
+ * Adds the dock that shows the annotated uniforms of a
+ * running shader; it stays hidden until there are some.
+ */
+void EditorWindow::addParameterDock(){
+    parameterDock = new QDockWidget(tr("Parameters"), this);
+    parameterDock->setObjectName("ParameterDock");
+    parameterDock->setAllowedAreas(Qt::LeftDockWidgetArea | Qt::RightDockWidgetArea | Qt::BottomDockWidgetArea);
+    addDockWidget(Qt::RightDockWidgetArea, parameterDock);
+    parameterDock->hide();
+}
+
 /**
  * @brief EditorWindow::saveDialog
  * @return bool - true if the user does not want to save or the
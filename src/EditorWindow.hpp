@@ -10,8 +10,15 @@
 #include <QFileDialog>
 #include <QMenuBar>
 #include <QStatusBar>
+#include <QLabel>
+#include <QDockWidget>
+#include <QSlider>
+#include <QFormLayout>
+#include <QHBoxLayout>
 
 #include "CodeEditor.hpp"
+#include "FrameStatistics.hpp"
+#include "ShaderParameter.hpp"
 
 /**
  * @brief The EditorWindow class
@@ -29,6 +36,8 @@ public:
     void showResults(const QString &);
     void warningDisplay(const QString &);
     void highlightErroredLine(int);
+    void showFrameStatistics(const FrameStatistics &);
+    void showParameters(const QList<ShaderParameter> &);
     void codeStopped();
 
     QString getSourceCode() const;
@@ -50,6 +59,8 @@ private Q_SLOTS:
     void gotOpenSettings();
     void gotCloseAll();
 
+    void parameterMoved(int);
+
 Q_SIGNALS:
     void closing(EditorWindow *);
     void closeAll(EditorWindow *);
@@ -60,6 +71,7 @@ Q_SIGNALS:
     void titleChanged(EditorWindow *);
     void changedSetting(EditorWindow *, const QString &, const QVariant &);
     void changedSettings(EditorWindow *, const QHash<QString, QVariant> &);
+    void changedParameter(EditorWindow *, const QString &, float);
 
 private:
     EditorWindow& operator=(const EditorWindow& rhs);
@@ -69,6 +81,8 @@ private:
     void addMenus();
     void addToolBars();
     void addStatusBar();
+    void addParameterDock();
+    void showParameterValue(int);
     void applySettings(const QHash<QString, QVariant> &);
     void loadFile(const QString &);
     bool saveFile(const QString &);
@@ -96,6 +110,11 @@ private:
     QAction *runAction;
     QAction *settingsAction;
     QAction *helpAction;
+    QLabel *statisticsLabel;
+    QDockWidget *parameterDock;
+    QList<ShaderParameter> parameters;
+    QList<QSlider*> parameterSliders;
+    QList<QLabel*> parameterLabels;
 };
 
 #endif // EDITORWINDOW
@@ -0,0 +1,45 @@
+#ifndef FRAMESTATISTICS_HPP
+#define FRAMESTATISTICS_HPP
+
+#include <QMetaType>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @brief The FrameStatistics struct
+ *
+ * Timing information about the frames a Renderer
+ * presented during the last measuring interval, which
+ * lasted interval milliseconds, and
+ * the fraction of the resolution it drew them at.
+ * CPU and GPU times are percentiles over a rolling window
+ * of recent frames; the GPU times of the sections of a
+ * frame, named by passNames, are averaged over the interval.
+ * GPU times are only valid if gpuFrames is not 0. While the
+ * frames are recorded, droppedFrames counts the frames the
+ * recording could not keep up with.
+ */
+struct FrameStatistics{
+    FrameStatistics() :
+        frames(0), interval(0), frameTime(0), maxFrameTime(0), missedDeadlines(0), resolutionScale(1),
+        cpuTime(0), cpuTimeP95(0), gpuTime(0), gpuTimeP95(0), gpuTimeP99(0), gpuFrames(0),
+        recording(false), droppedFrames(0)
+    { }
+    int frames;
+    double interval;
+    double frameTime;
+    double maxFrameTime;
+    int missedDeadlines;
+    double resolutionScale;
+    double cpuTime, cpuTimeP95;
+    double gpuTime, gpuTimeP95, gpuTimeP99;
+    int gpuFrames;
+    QVector<double> passTimes;
+    QStringList passNames;
+    bool recording;
+    int droppedFrames;
+};
+
+Q_DECLARE_METATYPE(FrameStatistics)
+
+#endif // FRAMESTATISTICS_HPP
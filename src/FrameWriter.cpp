@@ -0,0 +1,361 @@
+#include "FrameWriter.hpp"
+
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+const int FrameWriter::queueCapacity = 8;
+const int FrameWriter::closeTimeout = 2000;
+const int FrameWriter::pollInterval = 50;
+
+static const char frameMarker[] = "FRAME\n";
+static const int frameMarkerLength = sizeof(frameMarker) - 1;
+
+/**
+ * @brief FrameWriter::FrameWriter
+ * @param parent Parent object
+ */
+FrameWriter::FrameWriter(QObject *parent) :
+    QThread(parent),
+    format(Raw),
+    frameRate(60),
+    closing(false),
+    aborting(false),
+    opened(false),
+    dropped(0)
+{ }
+
+/**
+ * @brief FrameWriter::~FrameWriter
+ *
+ * Write the frames that are still queued and close the target
+ */
+FrameWriter::~FrameWriter(){
+    close();
+}
+
+/**
+ * @brief FrameWriter::open
+ * @param path File or named pipe to write to; replaced if it exists
+ * @param frameSize Size of every frame
+ * @param rate Frames per second announced in the Y4M header
+ *
+ * Start a recording. The target is opened by the writer thread,
+ * which waits there for the reader of a named pipe; failed() is
+ * emitted if that does not work. A running recording is closed first.
+ */
+void FrameWriter::open(const QString &path, const QSize &frameSize, int rate){
+    close();
+    QMutexLocker locker(&mutex);
+    target = path;
+    format = formatFor(path);
+    size = frameSize;
+    frameRate = qMax(1, rate);
+    closing = false;
+    aborting = false;
+    opened = true;
+    dropped = 0;
+    start();
+}
+
+/**
+ * @brief FrameWriter::close
+ *
+ * Write the frames that are still queued and stop the writer
+ * thread. Frames pushed afterwards are discarded. If a named pipe
+ * has no reader or the reader falls behind for closeTimeout
+ * milliseconds, the remaining frames are dropped instead.
+ */
+void FrameWriter::close(){
+    mutex.lock();
+    closing = true;
+    wakeUp.wakeOne();
+    mutex.unlock();
+    if(!wait(closeTimeout)){
+        // the writer checks for this at least every pollInterval
+        mutex.lock();
+        aborting = true;
+        mutex.unlock();
+        wait();
+    }
+
+    QMutexLocker locker(&mutex);
+    opened = false;
+    frames.clear();
+    freeBuffers.clear();
+}
+
+/**
+ * @brief FrameWriter::isOpen
+ * @return True while frames are accepted
+ */
+bool FrameWriter::isOpen() const{
+    QMutexLocker locker(&mutex);
+    return opened;
+}
+
+/**
+ * @brief FrameWriter::frameSize
+ * @return Size of the frames of the current recording
+ */
+QSize FrameWriter::frameSize() const{
+    QMutexLocker locker(&mutex);
+    return size;
+}
+
+/**
+ * @brief FrameWriter::droppedFrames
+ * @return Number of frames discarded because the writer fell behind
+ */
+int FrameWriter::droppedFrames() const{
+    QMutexLocker locker(&mutex);
+    return dropped;
+}
+
+/**
+ * @brief FrameWriter::takeBuffer
+ * @return A buffer for one RGBA frame of frameSize()
+ *
+ * Reuse a buffer the writer is done with if there is one
+ */
+QByteArray FrameWriter::takeBuffer(){
+    QMutexLocker locker(&mutex);
+    const int bytes = 4 * size.width() * size.height();
+    QByteArray buffer = freeBuffers.isEmpty() ? QByteArray() : freeBuffers.takeLast();
+    if(buffer.size() != bytes)
+        buffer = QByteArray(bytes, Qt::Uninitialized);
+    return buffer;
+}
+
+/**
+ * @brief FrameWriter::push
+ * @param frame Bottom-up RGBA rows of frameSize()
+ *
+ * Queue a frame for writing; it is dropped if the queue is full
+ */
+void FrameWriter::push(const QByteArray &frame){
+    QMutexLocker locker(&mutex);
+    if(!opened || closing)
+        return;
+    if(frames.size() >= queueCapacity){
+        ++dropped;
+        freeBuffers.append(frame);
+        return;
+    }
+    frames.enqueue(frame);
+    wakeUp.wakeOne();
+}
+
+/**
+ * @brief FrameWriter::formatFor
+ * @param path Target of a recording
+ * @return Y4M if path ends with ".y4m", otherwise Raw
+ */
+FrameWriter::Format FrameWriter::formatFor(const QString &path){
+    return path.endsWith(".y4m", Qt::CaseInsensitive) ? Y4M : Raw;
+}
+
+/**
+ * @brief FrameWriter::header
+ * @param format Format of the stream
+ * @param frameSize Size of every frame
+ * @param rate Frames per second
+ * @return The stream header; raw streams have none
+ */
+QByteArray FrameWriter::header(Format format, const QSize &frameSize, int rate){
+    if(format != Y4M)
+        return QByteArray();
+    return QString("YUV4MPEG2 W%1 H%2 F%3:1 Ip A1:1 C444\n")
+            .arg(frameSize.width()).arg(frameSize.height()).arg(rate).toLatin1();
+}
+
+/**
+ * @brief FrameWriter::encodedSize
+ * @param format Format of the stream
+ * @param frameSize Size of every frame
+ * @return Number of bytes encode() writes per frame
+ */
+int FrameWriter::encodedSize(Format format, const QSize &frameSize){
+    const int pixels = frameSize.width() * frameSize.height();
+    return format == Y4M ? frameMarkerLength + 3 * pixels : 4 * pixels;
+}
+
+/**
+ * @brief FrameWriter::encode
+ * @param format Format of the stream
+ * @param frameSize Size of the frame
+ * @param rgba Bottom-up RGBA rows
+ * @param target Receives encodedSize() bytes
+ *
+ * Flip the frame to top-down rows and, for Y4M, convert it
+ * to planar limited range BT.601 YCbCr behind a frame marker
+ */
+void FrameWriter::encode(Format format, const QSize &frameSize, const uchar *rgba, uchar *target){
+    const int width = frameSize.width(), height = frameSize.height();
+    if(format == Raw){
+        for(int y = 0; y < height; ++y)
+            std::memcpy(target + 4 * width * y, rgba + 4 * width * (height - 1 - y), 4 * width);
+        return;
+    }
+
+    std::memcpy(target, frameMarker, frameMarkerLength);
+    uchar *luma = target + frameMarkerLength;
+    uchar *blue = luma + width * height, *red = blue + width * height;
+    for(int y = 0; y < height; ++y){
+        const uchar *pixel = rgba + 4 * width * (height - 1 - y);
+        for(int x = 0; x < width; ++x, pixel += 4){
+            const int r = pixel[0], g = pixel[1], b = pixel[2];
+            *luma++ = uchar((( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+            *blue++ = uchar(((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+            *red++  = uchar(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+/**
+ * @brief FrameWriter::run
+ *
+ * Open the target and write queued frames until the
+ * recording is closed and the queue is empty
+ */
+void FrameWriter::run(){
+    mutex.lock();
+    const QString path = target;
+    QFile file(path);
+    const Format streamFormat = format;
+    const QSize frameSize = size;
+    const QByteArray streamHeader = header(format, size, frameRate);
+    mutex.unlock();
+
+    QString error;
+    if(!openTarget(file, error))
+        return;
+    if(!streamHeader.isEmpty())
+        writeData(file, streamHeader, error);
+
+    QByteArray encoded(encodedSize(streamFormat, frameSize), Qt::Uninitialized);
+    while(error.isEmpty()){
+        mutex.lock();
+        while(frames.isEmpty() && !closing)
+            wakeUp.wait(&mutex);
+        if(frames.isEmpty()){
+            mutex.unlock();
+            break;
+        }
+        QByteArray frame = frames.dequeue();
+        mutex.unlock();
+
+        encode(streamFormat, frameSize, reinterpret_cast<const uchar*>(frame.constData()),
+               reinterpret_cast<uchar*>(encoded.data()));
+        writeData(file, encoded, error);
+
+        mutex.lock();
+        freeBuffers.append(frame);
+        mutex.unlock();
+    }
+    file.close();
+
+    if(!error.isEmpty()){
+        mutex.lock();
+        opened = false;
+        frames.clear();
+        mutex.unlock();
+        Q_EMIT failed(tr("Recording to %1 failed: %2").arg(path, error));
+    }
+}
+
+/**
+ * @brief FrameWriter::openTarget
+ * @param file Receives the opened target
+ * @param error Receives the reason if the target can not be opened
+ * @return True if file is open, false if it failed or the recording
+ * was closed before a reader connected to the named pipe
+ *
+ * On Unix the target is opened without blocking; a named pipe
+ * without reader is retried every pollInterval until close().
+ */
+bool FrameWriter::openTarget(QFile &file, QString &error){
+#ifdef Q_OS_UNIX
+    const QByteArray name = QFile::encodeName(file.fileName());
+    int handle;
+    while((handle = ::open(name.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK, 0666)) < 0){
+        if(errno == EINTR)
+            continue;
+        if(errno != ENXIO){
+            error = QString::fromLocal8Bit(std::strerror(errno));
+            break;
+        }
+        QMutexLocker locker(&mutex);
+        if(closing)
+            break;
+        wakeUp.wait(&mutex, pollInterval);
+    }
+    if(handle >= 0 && !file.open(handle, QFile::WriteOnly | QFile::Unbuffered, QFileDevice::AutoCloseHandle)){
+        ::close(handle);
+        error = file.errorString();
+    }
+#else
+    if(!file.open(QFile::WriteOnly | QFile::Unbuffered))
+        error = file.errorString();
+#endif
+    if(file.isOpen())
+        return true;
+
+    mutex.lock();
+    opened = false;
+    frames.clear();
+    mutex.unlock();
+    if(!error.isEmpty())
+        Q_EMIT failed(tr("Recording to %1 failed: %2").arg(file.fileName(), error));
+    return false;
+}
+
+/**
+ * @brief FrameWriter::writeData
+ * @param file Opened target
+ * @param data Bytes to write
+ * @param error Receives the reason if not all bytes are written
+ * @return True if all bytes are written
+ *
+ * On Unix a full named pipe is polled every pollInterval,
+ * so close() can abort the write.
+ */
+bool FrameWriter::writeData(QFile &file, const QByteArray &data, QString &error){
+#ifdef Q_OS_UNIX
+    const int handle = file.handle();
+    qint64 written = 0;
+    while(written < data.size()){
+        const ssize_t count = ::write(handle, data.constData() + written, size_t(data.size() - written));
+        if(count >= 0){
+            written += count;
+            continue;
+        }
+        if(errno == EINTR)
+            continue;
+        if(errno != EAGAIN && errno != EWOULDBLOCK){
+            error = QString::fromLocal8Bit(std::strerror(errno));
+            return false;
+        }
+        mutex.lock();
+        const bool abort = aborting;
+        mutex.unlock();
+        if(abort){
+            error = tr("The reader did not keep up.");
+            return false;
+        }
+        pollfd reader = {handle, POLLOUT, 0};
+        ::poll(&reader, 1, pollInterval);
+    }
+    return true;
+#else
+    if(file.write(data) == data.size())
+        return true;
+    error = file.errorString();
+    return false;
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef FRAMEWRITER_HPP
+#define FRAMEWRITER_HPP
+
+#include <QThread>
+#include <QFile>
+#include <QSize>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QByteArray>
+
+/**
+ * @brief The FrameWriter class
+ *
+ * Streams rendered frames to a file or named pipe from a thread
+ * of its own, so neither the conversion nor a slow reader holds
+ * up rendering. Frames are handed over as bottom-up RGBA rows,
+ * the way OpenGL reads them back, and written either as YUV4MPEG2
+ * (4:4:4, if the target ends with ".y4m") or as top-down raw RGBA.
+ * At most queueCapacity frames wait for the writer; further frames
+ * are dropped and counted. Buffers come from takeBuffer() and are
+ * recycled once written, so a running recording does not allocate.
+ * Named pipes are opened and written without blocking, so closing
+ * never waits longer than closeTimeout for a reader.
+ */
+class FrameWriter : public QThread
+{
+    Q_OBJECT
+public:
+    enum Format{ Raw, Y4M };
+
+    explicit FrameWriter(QObject *parent = 0);
+    ~FrameWriter();
+    void open(const QString &, const QSize &, int);
+    void close();
+    bool isOpen() const;
+    QSize frameSize() const;
+    int droppedFrames() const;
+    QByteArray takeBuffer();
+    void push(const QByteArray &);
+
+    static Format formatFor(const QString &);
+    static QByteArray header(Format, const QSize &, int);
+    static int encodedSize(Format, const QSize &);
+    static void encode(Format, const QSize &, const uchar *, uchar *);
+
+    static const int queueCapacity;
+    static const int closeTimeout;
+    static const int pollInterval;
+
+Q_SIGNALS:
+    void failed(QString);
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    bool openTarget(QFile &, QString &);
+    bool writeData(QFile &, const QByteArray &, QString &);
+
+    QString target;
+    Format format;
+    QSize size;
+    int frameRate;
+
+    mutable QMutex mutex;
+    QWaitCondition wakeUp;
+    QQueue<QByteArray> frames;
+    QList<QByteArray> freeBuffers;
+    bool closing;
+    bool aborting;
+    bool opened;
+    int dropped;
+};
+
+#endif // FRAMEWRITER_HPP
@@ -0,0 +1,182 @@
+#include "GpuTimer.hpp"
+
+/**
+ * @brief GpuTimer::GpuTimer
+ *
+ * Create a timer that measures nothing until create() succeeds
+ */
+GpuTimer::GpuTimer() :
+    frameIndex(0),
+    section(-1),
+    supported(false),
+    measuring(false)
+{ }
+
+/**
+ * @brief GpuTimer::~GpuTimer
+ *
+ * The queries are freed by release(), which needs the context
+ */
+GpuTimer::~GpuTimer(){ }
+
+/**
+ * @brief GpuTimer::create
+ * @param context Context the queries are issued in; must be current
+ * @return True if the context supports timer queries
+ */
+bool GpuTimer::create(QOpenGLContext *context){
+    release();
+    supported = context->format().version() >= qMakePair(3, 3) ||
+            context->hasExtension("GL_ARB_timer_query");
+    return supported;
+}
+
+/**
+ * @brief GpuTimer::release
+ *
+ * Free the queries and drop outstanding results
+ */
+void GpuTimer::release(){
+    for(Frame &frame : frames){
+        qDeleteAll(frame.queries);
+        frame.queries.clear();
+        frame.used.clear();
+        frame.pending = false;
+    }
+    results.clear();
+    frameIndex = 0;
+    section = -1;
+    measuring = false;
+    supported = false;
+}
+
+/**
+ * @brief GpuTimer::isSupported
+ * @return True if frames can be measured
+ */
+bool GpuTimer::isSupported() const{
+    return supported;
+}
+
+/**
+ * @brief GpuTimer::beginFrame
+ * @param sections Number of sections the frame is divided into
+ *
+ * Collect the results that arrived and start measuring a frame
+ * if its queries are free again
+ */
+void GpuTimer::beginFrame(int sections){
+    measuring = false;
+    if(!supported)
+        return;
+    collect();
+
+    Frame &frame = frames[frameIndex];
+    if(frame.pending)
+        return;
+    for(int i = frame.queries.size(); i < sections; ++i){
+        QOpenGLTimerQuery *query = new QOpenGLTimerQuery();
+        if(!query->create()){
+            delete query;
+            release();
+            return;
+        }
+        frame.queries.append(query);
+    }
+    frame.used.fill(false, sections);
+    measuring = true;
+}
+
+/**
+ * @brief GpuTimer::begin
+ * @param index Section the following commands belong to
+ *
+ * Ignored if no frame is measured or another section is open
+ */
+void GpuTimer::begin(int index){
+    Frame &frame = frames[frameIndex];
+    if(!measuring || section >= 0 || index < 0 || index >= frame.used.size())
+        return;
+    frame.queries[index]->begin();
+    frame.used[index] = true;
+    section = index;
+}
+
+/**
+ * @brief GpuTimer::end
+ *
+ * Close the open section
+ */
+void GpuTimer::end(){
+    if(section < 0)
+        return;
+    frames[frameIndex].queries[section]->end();
+    section = -1;
+}
+
+/**
+ * @brief GpuTimer::endFrame
+ *
+ * Finish the frame; its results are collected by a later beginFrame().
+ * Frames without any section are dropped.
+ */
+void GpuTimer::endFrame(){
+    end();
+    if(!measuring || !frames[frameIndex].used.contains(true)){
+        measuring = false;
+        return;
+    }
+    frames[frameIndex].pending = true;
+    frameIndex = (frameIndex + 1) % frameCount;
+    measuring = false;
+}
+
+/**
+ * @brief GpuTimer::reset
+ *
+ * Drop the frames in flight and the collected results,
+ * e.g. because the sections mean something else from now on
+ */
+void GpuTimer::reset(){
+    end();
+    for(Frame &frame : frames)
+        frame.pending = false;
+    results.clear();
+    measuring = false;
+}
+
+/**
+ * @brief GpuTimer::takeResults
+ * @return GPU time of every section in milliseconds for each measured frame, oldest first
+ *
+ * Sections that were not drawn in a frame read 0.
+ */
+QList<QVector<double>> GpuTimer::takeResults(){
+    QList<QVector<double>> taken;
+    taken.swap(results);
+    return taken;
+}
+
+/**
+ * @brief GpuTimer::collect
+ *
+ * Read the finished frames in the order they were drawn.
+ * Stops at the first frame the GPU has not finished yet.
+ */
+void GpuTimer::collect(){
+    for(int i = 0; i < frameCount; ++i){
+        Frame &frame = frames[(frameIndex + i) % frameCount];
+        if(!frame.pending)
+            continue;
+        for(int j = 0; j < frame.used.size(); ++j)
+            if(frame.used[j] && !frame.queries[j]->isResultAvailable())
+                return;
+
+        QVector<double> times(frame.used.size(), 0.0);
+        for(int j = 0; j < frame.used.size(); ++j)
+            if(frame.used[j])
+                times[j] = frame.queries[j]->waitForResult() / 1000000.0;
+        results.append(times);
+        frame.pending = false;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GPUTIMER_HPP
+#define GPUTIMER_HPP
+
+#include <QOpenGLContext>
+#include <QOpenGLTimerQuery>
+#include <QVector>
+#include <QList>
+
+/**
+ * @brief The GpuTimer class
+ *
+ * Measures how long the GPU spends on the sections of a frame
+ * with GL_TIME_ELAPSED queries. The queries of frameCount frames
+ * are in flight at once and results are only read once the GPU
+ * has them, so measuring never waits for the GPU. If the results
+ * of a frame are still missing when its queries would be reused,
+ * the new frame is not measured. Queries must not overlap, so
+ * sections cannot be nested. All methods must be called with the
+ * context current that was passed to create().
+ */
+class GpuTimer
+{
+public:
+    GpuTimer();
+    ~GpuTimer();
+    bool create(QOpenGLContext *);
+    void release();
+    bool isSupported() const;
+    void beginFrame(int);
+    void begin(int);
+    void end();
+    void endFrame();
+    void reset();
+    QList<QVector<double>> takeResults();
+
+    static const int frameCount = 3;
+
+private:
+    struct Frame{
+        Frame() : pending(false) { }
+        QVector<QOpenGLTimerQuery*> queries;
+        QVector<bool> used;
+        bool pending;
+    };
+    void collect();
+
+    Frame frames[frameCount];
+    int frameIndex;
+    int section;
+    bool supported;
+    bool measuring;
+    QList<QVector<double>> results;
+};
+
+#endif // GPUTIMER_HPP
@@ -4,6 +4,9 @@
 #include <QObject>
 #include <QVariant>
 
+#include "../FrameStatistics.hpp"
+#include "../ShaderParameter.hpp"
+
 namespace Instances{
 /**
  * @brief The IInstance class
@@ -23,6 +26,8 @@ public:
     virtual void reportWarning(const QString &) = 0;
     virtual void codeStopped() = 0;
     virtual void highlightErroredLine(int) = 0;
+    virtual void reportFrameStatistics(const FrameStatistics &) = 0;
+    virtual void reportParameters(const QList<ShaderParameter> &) = 0;
     virtual QString sourceCode() const = 0;
     virtual QString title() const = 0;
 
@@ -41,6 +46,8 @@ Q_SIGNALS:
     void getSetting(IInstance *, const QString &key, QVariant &value);
     void getSettings(IInstance *, QHash<QString, QVariant> &settings);
 
+    void changeParameter(IInstance *, const QString &name, float value);
+
 protected:
     IInstance& operator=(const IInstance& rhs);
     IInstance& operator=(IInstance&& rhs);
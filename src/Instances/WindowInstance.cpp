@@ -82,6 +82,28 @@ void WindowInstance::highlightErroredLine(int lineno)
     _window->highlightErroredLine(lineno);
 }
 
+/**
+ * @brief WindowInstance::reportFrameStatistics
+ * @param statistics
+ *
+ * Displays the frame timing of the running renderer.
+ */
+void WindowInstance::reportFrameStatistics(const FrameStatistics &statistics)
+{
+    _window->showFrameStatistics(statistics);
+}
+
+/**
+ * @brief WindowInstance::reportParameters
+ * @param parameters
+ *
+ * Shows controls for the annotated uniforms of the running renderer.
+ */
+void WindowInstance::reportParameters(const QList<ShaderParameter> &parameters)
+{
+    _window->showParameters(parameters);
+}
+
 /**
  * @brief WindowInstance::codeStopped
  *
@@ -175,6 +197,18 @@ void WindowInstance::gotChangedSetting(EditorWindow *, const QString &key, const
     Q_EMIT changeSetting(this, key, value);
 }
 
+/**
+ * @brief WindowInstance::gotChangedParameter
+ * @param name
+ * @param value
+ *
+ * Signals that a uniform was set in the editor.
+ */
+void WindowInstance::gotChangedParameter(EditorWindow *, const QString &name, float value)
+{
+    Q_EMIT changeParameter(this, name, value);
+}
+
 void WindowInstance::gotDestroying(QObject*)
 {
     _window = 0;
@@ -220,6 +254,7 @@ void WindowInstance::createWindow(const QHash<QString,QVariant> &settings)
         connect(_window, SIGNAL(openSettings(EditorWindow*)), this, SLOT(gotOpenSettings(EditorWindow*)));
         connect(_window, SIGNAL(changedSetting(EditorWindow*,QString,QVariant)),         this, SLOT(gotChangedSetting(EditorWindow*,QString,QVariant)));
         connect(_window, SIGNAL(changedSettings(EditorWindow*,QHash<QString,QVariant>)), this, SLOT(gotChangedSettings(EditorWindow*,QHash<QString,QVariant>)));
+        connect(_window, SIGNAL(changedParameter(EditorWindow*,QString,float)),          this, SLOT(gotChangedParameter(EditorWindow*,QString,float)));
         _window->show();
     }
 }
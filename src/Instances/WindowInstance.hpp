@@ -23,6 +23,8 @@ public:
     virtual void reportError(const QString &message);
     virtual void reportWarning(const QString &);
     virtual void highlightErroredLine(int);
+    virtual void reportFrameStatistics(const FrameStatistics &);
+    virtual void reportParameters(const QList<ShaderParameter> &);
     virtual void codeStopped();
 
 private:
@@ -43,6 +45,7 @@ public Q_SLOTS:
     void gotOpenSettings(EditorWindow *);
     void gotChangedSetting(EditorWindow*, const QString &, const QVariant &);
     void gotChangedSettings(EditorWindow*, const QHash<QString,QVariant> &);
+    void gotChangedParameter(EditorWindow*, const QString &, float);
 };
 
 }
@@ -3,7 +3,7 @@ isEqual(QT_MAJOR_VERSION, 4) || isEqual(QT_MINOR_VERSION, 1) {
     error("Use at least Qt 5.2.")
 }
 
-QT       += core gui multimedia widgets
+QT       += core gui multimedia concurrent widgets
 
 TARGET = VeToLC
 TEMPLATE = app
@@ -67,31 +67,62 @@ QMAKE_EXTRA_TARGETS += first translations
 
 HEADERS += Instances/IInstance.hpp \
     Instances/WindowInstance.hpp \
+    AudioConverter.hpp \
     AudioInputProcessor.hpp \
     Backend.hpp \
     BootLoader.hpp \
     CodeEditor.hpp \
     CodeHighlighter.hpp \
     EditorWindow.hpp \
+    FrameWriter.hpp \
+    FrameStatistics.hpp \
+    GpuTimer.hpp \
     LiveThread.hpp \
+    ProgramBinaryCache.hpp \
     Renderer.hpp \
+    RenderWindow.hpp \
+    ResolutionController.hpp \
+    ShaderCompiler.hpp \
     SettingsBackend.hpp \
     SettingsTab.hpp \
     SettingsWindow.hpp \
+    ShaderWatchdog.hpp \
+    ShaderParameter.hpp \
+    ShaderLiterals.hpp \
+    SharedResources.hpp \
     SoundGenerator.hpp \
+    SpectrumAnalyzer.hpp \
+    TextureCache.hpp \
+    Timeline.hpp \
+    TimingWindow.hpp \
     AudioOutputProcessor.hpp
 
 SOURCES += Instances/WindowInstance.cpp \
+    AudioConverter.cpp \
     AudioInputProcessor.cpp \
     Backend.cpp \
     BootLoader.cpp \
     CodeEditor.cpp \
     CodeHighlighter.cpp \
     EditorWindow.cpp \
+    FrameWriter.cpp \
+    GpuTimer.cpp \
     main.cpp \
+    ProgramBinaryCache.cpp \
     Renderer.cpp \
+    RenderWindow.cpp \
+    ResolutionController.cpp \
+    ShaderCompiler.cpp \
     SettingsBackend.cpp \
     SettingsTab.cpp \
     SettingsWindow.cpp \
+    ShaderWatchdog.cpp \
+    ShaderParameter.cpp \
+    ShaderLiterals.cpp \
+    SharedResources.cpp \
     SoundGenerator.cpp \
+    SpectrumAnalyzer.cpp \
+    TextureCache.cpp \
+    Timeline.cpp \
+    TimingWindow.cpp \
     AudioOutputProcessor.cpp
@@ -10,6 +10,8 @@
 
 #include "SoundGenerator.hpp"
 #include "Renderer.hpp"
+#include "RenderWindow.hpp"
+#include "AudioInputProcessor.hpp"
 
 /**
  * @brief The LiveThread class
@@ -24,6 +26,9 @@ public:
     virtual void run() = 0;
     virtual void initialize(const QString &title, const QString &instructions) = 0;
     virtual bool updateCode(const QString &title, const QString &instructions) = 0;
+    virtual void applySettings(const QHash<QString, QVariant> &){ }
+    virtual void setParameter(const QString &, float){ }
+    virtual void stop(){ terminate(); }
     const long ID;
 private:
     LiveThread& operator=(const LiveThread& rhs);
@@ -149,34 +154,92 @@ Q_SIGNALS:
 };
 #endif
 
+/**
+ * @brief The GlLiveThread class
+ *
+ * A LiveThread that owns the render loop of a Renderer.
+ * The RenderWindow and the audio input, which all threads
+ * share, stay on the GUI thread;
+ * the Renderer and its OpenGL context live on this thread and
+ * its ShaderCompiler lives on a thread of its own.
+ */
 class GlLiveThread: public LiveThread{
     Q_OBJECT
 public:
     GlLiveThread(const long identity, QObject* parent = 0) : LiveThread(identity, parent){
         runObj = 0;
+        window = 0;
+        compiler = 0;
     }
     ~GlLiveThread(){
+        stop();
+        wait();
+        compilerThread.quit();
+        compilerThread.wait();
         if(runObj)
             delete runObj;
+        if(compiler)
+            delete compiler;
+        if(window)
+            delete window;
     }
     void run() Q_DECL_OVERRIDE{
-        if(runObj)
-            runObj->show();
+        if(!runObj)
+            return;
+        runObj->start();
+        exec();
+        runObj->stop();
+    }
+    void stop(){
+        quit();
     }
     // No parent object =(
     void initialize(const QString &title, const QString &instructions){
+        window = new RenderWindow(title);
+        connect(window, SIGNAL(doneSignal(QString)), this, SLOT(doneSignalReceived(QString)));
+
+        compiler = new ShaderCompiler();
+        compiler->moveToThread(&compilerThread);
+        connect(&compilerThread, SIGNAL(finished()), compiler, SLOT(release()), Qt::DirectConnection);
+        compilerThread.start();
+
         runObj = new Renderer(title, instructions);
-        connect(runObj, SIGNAL(doneSignal(QString)), this, SLOT(doneSignalReceived(QString)));
+        runObj->setWindow(window);
+        runObj->setCompiler(compiler);
         connect(runObj, SIGNAL(errored(QString,int)), this, SLOT(erroredReceived(QString, int)));
+        connect(runObj, SIGNAL(frameStatistics(FrameStatistics)), this, SLOT(frameStatisticsReceived(FrameStatistics)));
+        connect(runObj, SIGNAL(parametersChanged(QList<ShaderParameter>)),
+                this, SLOT(parametersReceived(QList<ShaderParameter>)));
+        connect(window, SIGNAL(exposed()), runObj, SLOT(renderLater()));
+        connect(window, SIGNAL(pauseRequested()), runObj, SLOT(toggleTimeline()));
+        connect(window, SIGNAL(seekRequested(qreal)), runObj, SLOT(seekTimeline(qreal)));
+        connect(window, SIGNAL(restartRequested()), runObj, SLOT(restartTimeline()));
+        connect(window, SIGNAL(speedRequested(qreal)), runObj, SLOT(scaleTimelineSpeed(qreal)));
+        connect(window, SIGNAL(recordRequested()), runObj, SLOT(toggleRecording()));
 
-        runObj->resize(800, 600);
-        runObj->show();
+        audio = AudioInputProcessor::shared();
+        runObj->setAudioInput(audio.data());
 
+        runObj->moveToThread(this);
+
+        window->resize(800, 600);
+        window->show();
     }
     bool updateCode(const QString &filename, const QString &code){
+        if(!runObj)
+            return false;
+        window->setTitle(filename);
+        window->show();
+        runObj->queueCode(filename, code);
+        return true;
+    }
+    void applySettings(const QHash<QString, QVariant> &settings){
         if(runObj)
-            return runObj->updateCode(filename, code);
-        return false;
+            runObj->queueSettings(settings);
+    }
+    void setParameter(const QString &name, float value){
+        if(runObj)
+            runObj->queueParameter(name, value);
     }
 public Q_SLOTS:
     void doneSignalReceived(QString exception){
@@ -185,11 +248,23 @@ public Q_SLOTS:
     void erroredReceived(QString error, int lineno){
         Q_EMIT errorSignal(this, error, lineno);
     }
+    void frameStatisticsReceived(FrameStatistics statistics){
+        Q_EMIT statisticsSignal(this, statistics);
+    }
+    void parametersReceived(QList<ShaderParameter> parameters){
+        Q_EMIT parametersSignal(this, parameters);
+    }
 Q_SIGNALS:
     void doneSignal(GlLiveThread*, QString);
     void errorSignal(GlLiveThread*, QString, int);
+    void statisticsSignal(GlLiveThread*, FrameStatistics);
+    void parametersSignal(GlLiveThread*, QList<ShaderParameter>);
 private:
     Renderer* runObj;
+    RenderWindow* window;
+    QSharedPointer<AudioInputProcessor> audio;
+    ShaderCompiler* compiler;
+    QThread compilerThread;
 };
 
 class QtSoundThread : public LiveThread{
@@ -0,0 +1,163 @@
+#include "ProgramBinaryCache.hpp"
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+const int ProgramBinaryCache::maxEntries = 256;
+
+static const quint32 binaryMagic = 0x5645544f; // "VETO"
+
+/**
+ * @brief ProgramBinaryCache::ProgramBinaryCache
+ * @param context The current context the binaries are made for
+ *
+ * Resolve the program binary functions and identify the driver
+ */
+ProgramBinaryCache::ProgramBinaryCache(QOpenGLContext *context) :
+    functions(context->functions()),
+    getProgramBinary(0), programBinary(0), programParameteri(0),
+    supported(false),
+    directory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/shaders")
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+    getProgramBinary  = reinterpret_cast<GetProgramBinary>(context->getProcAddress("glGetProgramBinary"));
+    programBinary     = reinterpret_cast<ProgramBinary>(context->getProcAddress("glProgramBinary"));
+    programParameteri = reinterpret_cast<ProgramParameteri>(context->getProcAddress("glProgramParameteri"));
+
+    GLint formats = 0;
+    if(getProgramBinary && programBinary && programParameteri)
+        functions->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    supported = formats > 0 && directory.mkpath(".");
+#endif
+
+    device.append(reinterpret_cast<const char*>(functions->glGetString(GL_VENDOR)));
+    device.append('\n');
+    device.append(reinterpret_cast<const char*>(functions->glGetString(GL_RENDERER)));
+    device.append('\n');
+    device.append(reinterpret_cast<const char*>(functions->glGetString(GL_VERSION)));
+}
+
+/**
+ * @brief ProgramBinaryCache::isSupported
+ * @return True if the driver can hand out program binaries
+ */
+bool ProgramBinaryCache::isSupported() const{
+    return supported;
+}
+
+/**
+ * @brief ProgramBinaryCache::fileName
+ * @param source Fragment shader source
+ * @return Path of the cache entry for source on this driver
+ */
+QString ProgramBinaryCache::fileName(const QString &source) const{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(device);
+    hash.addData(source.toUtf8());
+    return directory.filePath(QString::fromLatin1(hash.result().toHex()) + ".bin");
+}
+
+/**
+ * @brief ProgramBinaryCache::load
+ * @param source Fragment shader source
+ * @return A linked program or 0 if there is no usable binary
+ */
+QOpenGLShaderProgram *ProgramBinaryCache::load(const QString &source){
+    if(!supported)
+        return 0;
+
+    QFile file(fileName(source));
+    if(!file.open(QFile::ReadOnly))
+        return 0;
+
+    QDataStream in(&file);
+    quint32 magic = 0, format = 0;
+    QByteArray binary;
+    in >> magic >> format >> binary;
+    file.close();
+    if(in.status() != QDataStream::Ok || magic != binaryMagic || binary.isEmpty()){
+        file.remove();
+        return 0;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+    QOpenGLShaderProgram *program = new QOpenGLShaderProgram();
+    if(program->create()){
+        GLint linked = 0;
+        programBinary(program->programId(), format, binary.constData(), binary.size());
+        functions->glGetProgramiv(program->programId(), GL_LINK_STATUS, &linked);
+        // without shaders, link() only takes over the state of the binary
+        if(linked && program->link())
+            return program;
+    }
+    delete program;
+#endif
+
+    qWarning() << "Discarding rejected program binary" << file.fileName();
+    file.remove();
+    return 0;
+}
+
+/**
+ * @brief ProgramBinaryCache::prepare
+ * @param program Program that is about to be linked
+ *
+ * Ask the driver to keep the binary of program retrievable
+ */
+void ProgramBinaryCache::prepare(QOpenGLShaderProgram *program){
+    if(supported && program->programId())
+        programParameteri(program->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+/**
+ * @brief ProgramBinaryCache::store
+ * @param source Fragment shader source
+ * @param program Linked program built from source
+ *
+ * Write the binary of program to disk
+ */
+void ProgramBinaryCache::store(const QString &source, QOpenGLShaderProgram *program){
+    if(!supported || !program->isLinked())
+        return;
+
+    GLint length = 0;
+    functions->glGetProgramiv(program->programId(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+        return;
+
+    QByteArray binary(length, 0);
+    GLenum format = 0;
+    getProgramBinary(program->programId(), length, &length, &format, binary.data());
+    binary.resize(length);
+    if(binary.isEmpty())
+        return;
+
+    QSaveFile file(fileName(source));
+    if(!file.open(QFile::WriteOnly))
+        return;
+    QDataStream out(&file);
+    out << binaryMagic << quint32(format) << binary;
+    if(!file.commit()){
+        qWarning() << "Failed to write program binary" << file.fileName();
+        return;
+    }
+    prune();
+}
+
+/**
+ * @brief ProgramBinaryCache::prune
+ *
+ * Remove the least recently written entries beyond maxEntries
+ */
+void ProgramBinaryCache::prune(){
+    QFileInfoList entries = directory.entryInfoList(QStringList("*.bin"), QDir::Files, QDir::Time);
+    for(int i = maxEntries; i < entries.length(); ++i)
+        QFile::remove(entries[i].absoluteFilePath());
+}
@@ -0,0 +1,51 @@
+#ifndef PROGRAMBINARYCACHE_HPP
+#define PROGRAMBINARYCACHE_HPP
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+/**
+ * @brief The ProgramBinaryCache class
+ *
+ * Stores linked program binaries on disk and restores
+ * them on the next run. Entries are keyed by the shader
+ * source and the vendor, renderer and version of the
+ * driver; binaries the driver rejects are removed.
+ * Needs a current context for every call.
+ */
+class ProgramBinaryCache
+{
+public:
+    explicit ProgramBinaryCache(QOpenGLContext *);
+    bool isSupported() const;
+    QOpenGLShaderProgram *load(const QString &);
+    void prepare(QOpenGLShaderProgram *);
+    void store(const QString &, QOpenGLShaderProgram *);
+    static const int maxEntries;
+
+private:
+    typedef void (QOPENGLF_APIENTRYP GetProgramBinary)(GLuint, GLsizei, GLsizei *, GLenum *, void *);
+    typedef void (QOPENGLF_APIENTRYP ProgramBinary)(GLuint, GLenum, const void *, GLsizei);
+    typedef void (QOPENGLF_APIENTRYP ProgramParameteri)(GLuint, GLenum, GLint);
+
+    QString fileName(const QString &) const;
+    void prune();
+
+    QOpenGLFunctions *functions;
+    GetProgramBinary getProgramBinary;
+    ProgramBinary programBinary;
+    ProgramParameteri programParameteri;
+    bool supported;
+    QByteArray device;
+    QDir directory;
+};
+
+#endif // PROGRAMBINARYCACHE_HPP
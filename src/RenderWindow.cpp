@@ -0,0 +1,166 @@
+#include "RenderWindow.hpp"
+#include "Renderer.hpp"
+
+/**
+ * @brief RenderWindow::RenderWindow
+ * @param title Text for the title
+ * @param parent Parent object of the render window
+ *
+ * Create a new OpenGL window with the surface format of the Renderer
+ */
+RenderWindow::RenderWindow(const QString &title, QWindow *parent) :
+    QWindow(parent),
+    currentRefreshRate(60),
+    renderable(false)
+{
+    setTitle(title);
+    setSurfaceType(QWindow::OpenGLSurface);
+    setFormat(Renderer::surfaceFormat());
+}
+
+/**
+ * @brief RenderWindow::pixelSize
+ * @return Size of the window in device pixels
+ *
+ * Thread-safe.
+ */
+QSize RenderWindow::pixelSize() const{
+    QMutexLocker locker(&stateMutex);
+    return currentPixelSize;
+}
+
+/**
+ * @brief RenderWindow::mousePosition
+ * @return Last mouse position relative to the window size
+ *
+ * Thread-safe.
+ */
+QVector2D RenderWindow::mousePosition() const{
+    QMutexLocker locker(&stateMutex);
+    return currentMousePosition;
+}
+
+/**
+ * @brief RenderWindow::refreshRate
+ * @return Refresh rate of the screen the window is on
+ *
+ * Thread-safe.
+ */
+qreal RenderWindow::refreshRate() const{
+    QMutexLocker locker(&stateMutex);
+    return currentRefreshRate;
+}
+
+/**
+ * @brief RenderWindow::isRenderable
+ * @return True if the window is exposed and has a size
+ *
+ * Thread-safe.
+ */
+bool RenderWindow::isRenderable() const{
+    QMutexLocker locker(&stateMutex);
+    return renderable;
+}
+
+/**
+ * @brief RenderWindow::updateState
+ *
+ * Publish the current geometry and visibility for the render thread
+ */
+void RenderWindow::updateState(){
+    QMutexLocker locker(&stateMutex);
+    currentPixelSize = size() * devicePixelRatio();
+    if(screen() && screen()->refreshRate() > 0)
+        currentRefreshRate = screen()->refreshRate();
+    renderable = isExposed() && !currentPixelSize.isEmpty();
+}
+
+/**
+ * @brief RenderWindow::event
+ * @param event The event that should be proccessed
+ * @return True if the event was successful proccessed, otherwise false
+ *
+ * Q_EMIT doneSignal on close event.
+ */
+bool RenderWindow::event(QEvent *event){
+    switch(event->type()){
+    case QEvent::Close:
+        Q_EMIT doneSignal(tr("User closed renderer"));
+        return true;
+    default:
+        return QWindow::event(event);
+    }
+}
+
+/**
+ * @brief RenderWindow::exposeEvent
+ *
+ * Called if the window is ready to start rendering
+ */
+void RenderWindow::exposeEvent(QExposeEvent *){
+    updateState();
+    if(isRenderable())
+        Q_EMIT exposed();
+}
+
+/**
+ * @brief RenderWindow::resizeEvent
+ *
+ * Called if the size of the window changed
+ */
+void RenderWindow::resizeEvent(QResizeEvent *){
+    updateState();
+}
+
+/**
+ * @brief RenderWindow::mouseMoveEvent
+ * @param event The mouse event
+ *
+ * Remember the mouse position for the mouse uniform
+ */
+void RenderWindow::mouseMoveEvent(QMouseEvent *event){
+    QMutexLocker locker(&stateMutex);
+    currentMousePosition = QVector2D((float)event->pos().x() / (float)qMax(1, width()),
+                                     (float)event->pos().y() / (float)qMax(1, height()));
+}
+
+/**
+ * @brief RenderWindow::keyPressEvent
+ * @param event The key event
+ *
+ * Control the time of the shader: space pauses and resumes,
+ * the left and right arrows move it by five seconds(one with
+ * shift), home moves it back to the start and the up and down
+ * arrows double and halve its speed. R starts and stops
+ * recording the frames.
+ */
+void RenderWindow::keyPressEvent(QKeyEvent *event){
+    qreal seekStep = event->modifiers() & Qt::ShiftModifier ? 1000 : 5000;
+    switch(event->key()){
+    case Qt::Key_Space:
+        Q_EMIT pauseRequested();
+        break;
+    case Qt::Key_Left:
+        Q_EMIT seekRequested(-seekStep);
+        break;
+    case Qt::Key_Right:
+        Q_EMIT seekRequested(seekStep);
+        break;
+    case Qt::Key_Home:
+        Q_EMIT restartRequested();
+        break;
+    case Qt::Key_Up:
+        Q_EMIT speedRequested(2);
+        break;
+    case Qt::Key_Down:
+        Q_EMIT speedRequested(0.5);
+        break;
+    case Qt::Key_R:
+        Q_EMIT recordRequested();
+        break;
+    default:
+        QWindow::keyPressEvent(event);
+        return;
+    }
+    event->accept();
+}
@@ -0,0 +1,59 @@
+#ifndef RENDERWINDOW_HPP
+#define RENDERWINDOW_HPP
+
+#include <QWindow>
+#include <QScreen>
+#include <QMutex>
+#include <QVector2D>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QResizeEvent>
+#include <QExposeEvent>
+
+/**
+ * @brief The RenderWindow class
+ *
+ * A subclass of QWindow that serves as the OpenGL surface
+ * of a Renderer. It lives on the GUI thread and publishes
+ * its size, the mouse position and its visibility so that
+ * a Renderer on another thread can read them safely.
+ * Keys that control the time of the shader and the
+ * recording are forwarded as signals.
+ */
+class RenderWindow : public QWindow
+{
+    Q_OBJECT
+public:
+    explicit RenderWindow(const QString &, QWindow *parent = 0);
+    QSize pixelSize() const;
+    QVector2D mousePosition() const;
+    qreal refreshRate() const;
+    bool isRenderable() const;
+
+Q_SIGNALS:
+    void doneSignal(QString);
+    void exposed();
+    void pauseRequested();
+    void seekRequested(qreal);
+    void restartRequested();
+    void speedRequested(qreal);
+    void recordRequested();
+
+protected:
+    virtual bool event(QEvent *);
+    virtual void exposeEvent(QExposeEvent *);
+    virtual void resizeEvent(QResizeEvent *);
+    virtual void mouseMoveEvent(QMouseEvent *);
+    virtual void keyPressEvent(QKeyEvent *);
+
+private:
+    void updateState();
+
+    mutable QMutex stateMutex;
+    QSize currentPixelSize;
+    QVector2D currentMousePosition;
+    qreal currentRefreshRate;
+    bool renderable;
+};
+
+#endif // RENDERWINDOW_HPP
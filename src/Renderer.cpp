@@ -1,72 +1,92 @@
 #include "Renderer.hpp"
 
-
-static GLfloat vertices[] = {
-    1, 1,0,  1,-1,0, -1,1,0,
-    1,-1,0, -1,-1,0, -1,1,0
-};
-static GLfloat uvs[] = {
-    1,0, 1,1, 0,0,
-    1,1, 0,1, 0,0
-};
-
-const char * Renderer::defaultVertexShader =
-        "#version 330 core\n"
-        "\n"
-        "in vec3 position;\n"
-        "in vec2 texCoord;\n"
-        "\n"
-        "out vec2  uv;\n"
-        "\n"
-        "void main(){\n"
-        "   gl_Position = vec4(position, 1);\n"
-        "   uv = texCoord;\n"
-        "}";
-
-const char * Renderer::defaultFragmentShader =
+const int Renderer::audioHistoryRows = 256;
+const int Renderer::firstImageUnit = 6;
+const GLuint Renderer::builtinBinding = 0;
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+
+#ifndef GL_RGBA16F
+#define GL_RGBA16F 0x881A
+#endif
+
+#ifndef GL_PROGRAM_POINT_SIZE
+#define GL_PROGRAM_POINT_SIZE 0x8642
+#endif
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_SHADER_STORAGE_BLOCK
+#define GL_SHADER_STORAGE_BLOCK 0x92E6
+#endif
+#ifndef GL_BUFFER_DATA_SIZE
+#define GL_BUFFER_DATA_SIZE 0x9303
+#endif
+
+static const char *copyFragmentShader =
         "#version 330 core\n"
         "\n"
+        "uniform sampler2D image;\n"
+        "uniform vec2 targetSize;\n"
         "out vec4 color;\n"
         "\n"
-        "in vec2 uv;\n"
-        "uniform float time;\n"
-        "uniform vec2 mouse;\n"
-        "uniform float ration;\n"
-        "\n"
         "void main(){\n"
-        "     color = vec4(cos(uv.x * 5 - time / 1000) / 2 + .5, 0, sin(uv.x * 5 - time / 1000) / 2 + .5, 1);\n"
+        "    color = texture(image, gl_FragCoord.xy / targetSize);\n"
         "}";
 
 /**
  * @brief Renderer::Renderer
- * @param parent Parent object of the render window
+ * @param parent Parent object of the renderer
  *
  * Create a new Renderer with default shader
  */
-Renderer::Renderer(QWindow *parent) : Renderer::Renderer("new", defaultFragmentShader, parent){ }
+Renderer::Renderer(QObject *parent) : Renderer::Renderer("new", ShaderCompiler::defaultFragmentShader, parent){ }
 
 /**
  * @brief Renderer::Renderer
- * @param filename Name that should shown in the title
+ * @param filename Name of the shader file; used to find texture images
  * @param instructions Shader code for execution
- * @param parent Parent object of the render window
+ * @param parent Parent object of the renderer
  *
- * Create a new Renderer with given code and set filename as title
+ * Create a new Renderer with given code
  */
-Renderer::Renderer(const QString &filename, const QString &instructions, QWindow *parent) :
-    QWindow(parent),
+Renderer::Renderer(const QString &filename, const QString &instructions, QObject *parent) :
+    QObject(parent),
     currentFile(filename),
     clearColor(Qt::black),
-    context(0), device(0),
-    time(0),
-    pendingUpdate(false),
-    vao(0), uvBuffer(0), audioLeftTexture(0), audioRightTexture(0),
-    vertexAttr(0), uvAttr(0), timeUniform(0),
-    shaderProgram(0),
+    context(0), surface(0), window(0), offscreenSurface(0),
+    frameTimer(this),
+    lastFrameStart(-1), frameRateCap(0), scaledTarget(0),
+    progressiveTiles(0), tileIndex(0), samples(0), accumulate(false), accumulated(false),
+    sampleTime(0), sampleTarget(0), accumulationTarget(0),
+    readbackNext(0), readbackPending(0),
+    coreFunctions(0), computeFunctions(0), vao(0), pointVao(0),
+    spectrumLeftTexture(0), spectrumRightTexture(0), audioHistoryTexture(0),
+    builtinBuffer(0), frameIndex(0), lastRenderTime(-1),
+    audioPixelBufferIndex(0), legacyAudio(false), spectrum(false), audioHistory(false),
+    spectrumSize(1024), audioHistoryRow(0), spectrumHandle(-1), spectrumSmoothing(0.8f),
+    vertexAttr(0), uvAttr(0),
+    shader(0), goodShader(0), resolutionScale(0), resolutionReduced(false), bufferIndex(0), clearStorage(false), copyProgram(0), compiler(0),
     fragmentSource(instructions),
-    textureRegEx("(^|\n|\r)\\s*#texture\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+([^\n\r]+)")
+    audioInput(0), spectrumSequence(0),
+    audioWindow(2 * SpectrumAnalyzer::maximumSize, 0.f)
 {
-    setTitle(filename);
+    for(GLuint &buffer : audioPixelBuffers)
+        buffer = 0;
+    for(int i = 0; i < 3; ++i){
+        readbackBuffers[i] = 0;
+        readbackFences[i] = 0;
+    }
+    std::memset(&builtins, 0, sizeof(builtins));
 
     m_logger = new QOpenGLDebugLogger( this );
 
@@ -74,46 +94,286 @@ Renderer::Renderer(const QString &filename, const QString &instructions, QWindow
              this, SLOT(onMessageLogged(QOpenGLDebugMessage)),
              Qt::DirectConnection );
 
-    setSurfaceType(QWindow::OpenGLSurface);
+    qRegisterMetaType<FrameStatistics>("FrameStatistics");
+    qRegisterMetaType<QList<ShaderParameter>>("QList<ShaderParameter>");
 
+    connect(&recorder, SIGNAL(failed(QString)), this, SLOT(recordingFailed(QString)));
 
-    time = new QTime();
-    time->start();
+    frameTimer.setSingleShot(true);
+    frameTimer.setTimerType(Qt::PreciseTimer);
+    connect(&frameTimer, SIGNAL(timeout()), this, SLOT(renderNow()));
+}
 
-    audio = new AudioInputProcessor(this);
-    connect(audio, SIGNAL(processData(QByteArray)), this, SLOT(updateAudioData(QByteArray)));
-    audio->start();
+/**
+ * @brief Renderer::~Renderer
+ *
+ * Free resources
+ */
+Renderer::~Renderer(){
+    release();
+    delete m_logger;
+    delete offscreenSurface;
+}
 
+/**
+ * @brief Renderer::surfaceFormat
+ * @return The surface format every renderer uses
+ */
+QSurfaceFormat Renderer::surfaceFormat(){
     QSurfaceFormat format;
     format.setMajorVersion(3);
     format.setMinorVersion(3);
     format.setSamples(4);
     format.setProfile(QSurfaceFormat::CoreProfile);
-    setFormat(format);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 3, 0)
+    format.setSwapInterval(1);
+#endif
+    return format;
 }
 
 /**
- * @brief Renderer::~Renderer
+ * @brief Renderer::setWindow
+ * @param renderWindow Window to draw into
  *
- * Free resources
+ * Must be called before start()
  */
-Renderer::~Renderer(){
-    context->makeCurrent(this);
-    if(shaderProgram){
-        shaderProgram->bind();
-        for(QOpenGLTexture *texture : textures){
-            texture->destroy();
-            delete texture;
-        }
-        delete shaderProgram;
+void Renderer::setWindow(RenderWindow *renderWindow){
+    window = renderWindow;
+    surface = renderWindow;
+}
+
+/**
+ * @brief Renderer::setCompiler
+ * @param shaderCompiler Compiler that builds new programs in the background
+ *
+ * Must be called before start(). Without a compiler, code is
+ * compiled on the render thread.
+ */
+void Renderer::setCompiler(ShaderCompiler *shaderCompiler){
+    compiler = shaderCompiler;
+    connect(compiler, SIGNAL(compiled()), this, SLOT(renderLater()));
+}
+
+/**
+ * @brief Renderer::setAudioInput
+ * @param input Audio input the audio textures are filled from
+ *
+ * Must be called before start()
+ */
+void Renderer::setAudioInput(AudioInputProcessor *input){
+    audioInput = input;
+}
+
+/**
+ * @brief Renderer::initContext
+ * @param target Surface to render on
+ * @return True on success, otherwise false
+ *
+ * Create the OpenGL context in the current thread
+ */
+bool Renderer::initContext(QSurface *target){
+    surface = target;
+    context = new QOpenGLContext(this);
+    context->setFormat(surfaceFormat());
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+    // lets all renderers share the textures of the TextureCache
+    context->setShareContext(QOpenGLContext::globalShareContext());
+#endif
+    if(!context->create()){
+        delete context;
+        context = 0;
+        return false;
+    }
+
+    if(compiler && !compiler->createContext(context)){
+        qWarning() << tr("Failed to create a shared context; compiling shaders on the render thread.");
+        compiler = 0;
+    }
+
+    if(!context->makeCurrent(surface)){
+        delete context;
+        context = 0;
+        return false;
+    }
+
+    if (m_logger->initialize()){
+        m_logger->startLogging( QOpenGLDebugLogger::SynchronousLogging );
+        m_logger->enableMessages();
+    }
+    initializeOpenGLFunctions();
+    coreFunctions = context->versionFunctions<QOpenGLFunctions_3_3_Core>();
+    if(!coreFunctions || !coreFunctions->initializeOpenGLFunctions()){
+        qWarning() << tr("OpenGL 3.3 is not supported; built-in uniforms are set one by one.");
+        coreFunctions = 0;
+    }
+    // compute passes and storage buffers are only available with OpenGL 4.3
+    computeFunctions = context->versionFunctions<QOpenGLFunctions_4_3_Core>();
+    if(computeFunctions && !computeFunctions->initializeOpenGLFunctions())
+        computeFunctions = 0;
+    if(!gpuTimer.create(context))
+        qWarning() << tr("Timer queries are not supported; GPU times are not measured.");
+    return true;
+}
+
+/**
+ * @brief Renderer::start
+ *
+ * Create the context on the thread the renderer lives on
+ * and start the render loop
+ */
+void Renderer::start(){
+    if(context || !window)
+        return;
+    if(!initContext(window)){
+        Q_EMIT errored(tr("Failed to create an OpenGL context."), -1);
+        return;
+    }
+    if(!init() && !resources){
+        Q_EMIT errored(tr("OpenGL 3.3 is required for rendering."), -1);
+        release();
+        return;
     }
-    glDeleteBuffers(1, &uvBuffer);
-    glDeleteTextures(1, &audioLeftTexture);
-    glDeleteTextures(1, &audioRightTexture);
-    delete time;
+    timeline.restart();
+    renderLater();
+}
+
+/**
+ * @brief Renderer::stop
+ *
+ * Stop the render loop and free the graphic resources.
+ * Must be called on the thread the renderer lives on.
+ */
+void Renderer::stop(){
+    frameTimer.stop();
+    release();
+}
+
+/**
+ * @brief Renderer::release
+ *
+ * Free the graphic resources and the context
+ */
+void Renderer::release(){
+    if(!context)
+        return;
+    context->makeCurrent(surface);
+    if(compiler)
+        qDeleteAll(compiler->takeResults());
+    for(RenderPass &pass : passes)
+        releaseBuffers(pass);
+    passes.clear();
+    releaseStorageBuffers();
+    delete shader;
+    shader = 0;
+    delete goodShader;
+    goodShader = 0;
+    delete copyProgram;
+    copyProgram = 0;
+    delete scaledTarget;
+    scaledTarget = 0;
+    delete sampleTarget;
+    delete accumulationTarget;
+    sampleTarget = accumulationTarget = 0;
+    accumulated = false;
+    gpuTimer.release();
+    stopRecording();
+    resources.clear();
+    audioTextures = SharedResources::AudioTextures();
+    glDeleteTextures(1, &spectrumLeftTexture);
+    glDeleteTextures(1, &spectrumRightTexture);
+    spectrumLeftTexture = spectrumRightTexture = 0;
+    glDeleteTextures(1, &audioHistoryTexture);
+    audioHistoryTexture = 0;
+    glDeleteBuffers(3, audioPixelBuffers);
+    if(audioInput)
+        audioInput->releaseSpectrum(spectrumHandle);
+    spectrumHandle = -1;
+    glDeleteBuffers(1, &builtinBuffer);
+    builtinBuffer = 0;
+    coreFunctions = 0;
+    computeFunctions = 0;
     delete vao;
-    delete device;
-    delete m_logger;
+    vao = 0;
+    delete pointVao;
+    pointVao = 0;
+    m_logger->stopLogging();
+    context->doneCurrent();
+    delete context;
+    context = 0;
+}
+
+/**
+ * @brief Renderer::exportFrames
+ * @param frameSize Resolution of the exported frames
+ * @param frames Number of frames to render
+ * @param timestep Time between two frames in seconds
+ * @param target Path of the output file; the frame number is appended to its base name
+ * @return True on success, otherwise false
+ *
+ * Render the shader without a window into a framebuffer object
+ * with a fixed timestep and write every frame to disk.
+ * Frames are written as raw RGBA data if target ends with ".raw",
+ * otherwise in the image format implied by its suffix.
+ */
+bool Renderer::exportFrames(const QSize &frameSize, int frames, qreal timestep, const QString &target){
+    if(context)
+        return false;
+
+    offscreenSurface = new QOffscreenSurface();
+    offscreenSurface->setFormat(surfaceFormat());
+    offscreenSurface->create();
+
+    if(!initContext(offscreenSurface)){
+        qWarning() << tr("Failed to create an offscreen OpenGL context.");
+        return false;
+    }
+    if(!init())
+        return false;
+
+    QOpenGLFramebufferObjectFormat fboFormat;
+    fboFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    QOpenGLFramebufferObject fbo(frameSize, fboFormat);
+    fbo.bind();
+
+    bool result = true;
+    for(int frame = 0; result && frame < frames; ++frame){
+        render(frameSize, frame * timestep * 1000, QVector2D(0, 0));
+        result = writeFrame(fbo.toImage(), frame, target);
+    }
+
+    fbo.release();
+    return result;
+}
+
+/**
+ * @brief Renderer::writeFrame
+ * @param image Rendered frame
+ * @param frame Number of the frame
+ * @param target Path of the output file
+ * @return True on success, otherwise false
+ *
+ * Write a single exported frame next to target, numbered by frame.
+ */
+bool Renderer::writeFrame(const QImage &image, int frame, const QString &target){
+    QFileInfo info(target);
+    QString fileName = info.dir().filePath(info.completeBaseName() +
+                                           QString("%1").arg(frame, 5, 10, QChar('0')) +
+                                           "." + info.suffix());
+
+    if(info.suffix().compare("raw", Qt::CaseInsensitive) != 0){
+        if(image.save(fileName))
+            return true;
+        qWarning() << tr("Failed to write frame") << fileName;
+        return false;
+    }
+
+    QFile file(fileName);
+    if(!file.open(QFile::WriteOnly)){
+        qWarning() << tr("Failed to write frame") << fileName << file.errorString();
+        return false;
+    }
+    QImage rgba = image.convertToFormat(QImage::Format_RGBA8888);
+    return file.write(reinterpret_cast<const char*>(rgba.constBits()), rgba.byteCount()) == rgba.byteCount();
 }
 
 /**
@@ -128,173 +388,342 @@ bool Renderer::init(){
     vao->create();
     vao->bind();
 
-    glDeleteBuffers(1, &vertexBuffer);
-    glGenBuffers(1, &vertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glDeleteBuffers(1, &uvBuffer);
-    glGenBuffers(1, &uvBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(uvs), uvs, GL_STATIC_DRAW);
+    // the quad and the audio textures are shared by all renderers
+    resources = SharedResources::acquire(coreFunctions);
+    if(!resources){
+        qWarning() << tr("OpenGL 3.3 is required to share the render resources.");
+        vao->release();
+        return false;
+    }
 
     glEnable(GL_TEXTURE_1D);
     glEnable(GL_TEXTURE_2D);
 
-    glDeleteTextures(1, &audioLeftTexture);
-    glGenTextures(1, &audioLeftTexture);
-    glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-
-
-    glDeleteTextures(1, &audioRightTexture);
-    glGenTextures(1, &audioRightTexture);
-    glBindTexture(GL_TEXTURE_1D, audioRightTexture);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    // vertex passes draw without buffers and may size their points
+    delete pointVao;
+    pointVao = new QOpenGLVertexArrayObject(this);
+    pointVao->create();
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    legacyAudio = false;
+
+    glDeleteTextures(1, &spectrumLeftTexture);
+    glDeleteTextures(1, &spectrumRightTexture);
+    spectrumLeftTexture = spectrumRightTexture = 0;
+    spectrum = false;
+
+    glDeleteTextures(1, &audioHistoryTexture);
+    audioHistoryTexture = 0;
+    audioHistory = false;
+    updateSpectrumAnalysis();
+
+    glDeleteBuffers(3, audioPixelBuffers);
+    glGenBuffers(3, audioPixelBuffers);
+    for(GLuint buffer : audioPixelBuffers){
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, audioWindow.size() * sizeof(float), 0, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    uploadAudioData(true);
+
+    // the binding of the built-in uniform block stays the same for all programs
+    glDeleteBuffers(1, &builtinBuffer);
+    builtinBuffer = 0;
+    if(coreFunctions){
+        glGenBuffers(1, &builtinBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, builtinBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(BuiltinUniforms), 0, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        coreFunctions->glBindBufferBase(GL_UNIFORM_BUFFER, builtinBinding, builtinBuffer);
+    }
+    frameIndex = 0;
+    lastRenderTime = -1;
+
+    delete copyProgram;
+    copyProgram = new QOpenGLShaderProgram(this);
+    copyProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, ShaderCompiler::defaultVertexShader);
+    copyProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, copyFragmentShader);
+    copyProgram->bindAttributeLocation("position", 0);
+    copyProgram->bindAttributeLocation("texCoord", 1);
+    if(!copyProgram->link())
+        qWarning() << tr("Failed to link the buffer copy program.");
+    copyProgram->bind();
+    copyProgram->setUniformValue("image", GLint(0));
 
     glClearColor(0, 0, 0.3, 1);
-    bool result = initShaders(fragmentSource);
+    bool result;
+    if(compiler){
+        QVector<float> values;
+        queuedSkeleton = ShaderLiterals::hoist(fragmentSource, values);
+        compiler->queueCode(currentFile, fragmentSource);
+        result = initShaders(ShaderCompiler::defaultFragmentShader);
+    }else{
+        result = initShaders(fragmentSource);
+    }
 
     vao->release();
 
     return result;
 }
 
+/**
+ * @brief Renderer::createLegacyAudioTextures
+ *
+ * Request the planar audioLeft and audioRight textures that
+ * older shaders use instead of the audio texture
+ */
+void Renderer::createLegacyAudioTextures(){
+    legacyAudio = true;
+    uploadAudioData(true);
+}
+
+/**
+ * @brief Renderer::createSpectrumTextures
+ *
+ * Create the audioSpectrumLeft and audioSpectrumRight textures
+ * for the configured spectrum size and start the analysis.
+ * Existing spectrum textures are replaced.
+ */
+void Renderer::createSpectrumTextures(){
+    GLuint *spectrumTextures[] = {&spectrumLeftTexture, &spectrumRightTexture};
+    for(GLuint *spectrumTexture : spectrumTextures){
+        glDeleteTextures(1, spectrumTexture);
+        glGenTextures(1, spectrumTexture);
+        glBindTexture(GL_TEXTURE_1D, *spectrumTexture);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        SharedResources::allocateTexture1D(GL_R32F, spectrumSize / 2);
+    }
+    spectrum = true;
+    updateSpectrumAnalysis();
+    uploadAudioData(true);
+}
+
+/**
+ * @brief Renderer::createAudioHistoryTexture
+ *
+ * Create the audioHistory texture: audioHistoryRows rows of
+ * spectrumSize / 2 bins with the left magnitudes in .r and the
+ * right ones in .g. Every new spectrum overwrites the oldest row,
+ * so the rows wrap around; the texture repeats vertically to let
+ * shaders sample across the seam. Starts the analysis if needed.
+ * An existing history texture is replaced.
+ */
+void Renderer::createAudioHistoryTexture(){
+    const int bins = spectrumSize / 2;
+    std::vector<float> silence(2 * bins * audioHistoryRows, 0.f);
+
+    glDeleteTextures(1, &audioHistoryTexture);
+    glGenTextures(1, &audioHistoryTexture);
+    glBindTexture(GL_TEXTURE_2D, audioHistoryTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, bins, audioHistoryRows, 0, GL_RG, GL_FLOAT, silence.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    audioHistoryRow = 0;
+    audioHistory = true;
+    updateSpectrumAnalysis();
+}
+
+/**
+ * @brief Renderer::updateSpectrumAnalysis
+ *
+ * Acquire the analysis for the configured spectrum size and
+ * smoothing from the audio input while a shader samples the
+ * spectrum or the history, and release the previous one.
+ * Renderers with the same settings share an analysis.
+ */
+void Renderer::updateSpectrumAnalysis(){
+    if(!audioInput)
+        return;
+    int handle = -1;
+    if(spectrum || audioHistory)
+        handle = audioInput->acquireSpectrum(spectrumSize, spectrumSmoothing);
+    audioInput->releaseSpectrum(spectrumHandle);
+    spectrumHandle = handle;
+    spectrumSequence = 0;
+}
+
 /**
  * @brief Renderer::initShaders
  * @param fragmentShader Code to compile as shader
  * @return True on success, otherwise false
  *
- * Initialze and compile the shader program
+ * Compile the shader program on the render thread and use it
  */
-bool Renderer::initShaders(QString fragmentShader){
-    QList<QPair<QString, QString>> images;
-	QFileInfo codeFile(currentFile);
-
-    int pos = 0;
-    while((pos = textureRegEx.indexIn(fragmentShader, pos)) != -1){
-        QString imageName = textureRegEx.cap(2).trimmed();
-        QString imagePath = textureRegEx.cap(3).trimmed();
-        QFileInfo textureImage;
-		
-        if(codeFile.exists())
-            textureImage = QFileInfo(codeFile.dir(), imagePath);
-        else
-            textureImage = QFileInfo(imagePath);
-
-        if(!textureImage.isFile()){
-            qDebug() << "Texture image does not exsit: " << imagePath;
-            if(fragmentShader == defaultFragmentShader)
-                qWarning() << tr("Failed to compile default shader.");
-            else if(shaderProgram == 0)
-                initShaders(defaultFragmentShader);
-            Q_EMIT errored("Image file does not exist: " + imagePath, fragmentShader.mid(0, pos).count('\n'));
-            return false;
-        }
+bool Renderer::initShaders(const QString &fragmentShader){
+    return useShader(ShaderCompiler::compile(currentFile, fragmentShader));
+}
 
-        images.append(QPair<QString, QString>(imageName, textureImage.absoluteFilePath()));
-
-        QString textureDefinition(textureRegEx.cap(1) + "uniform sampler2D " + imageName + ";");
-        fragmentShader.remove(pos, textureRegEx.matchedLength());
-        fragmentShader.insert(pos, textureDefinition);
-        pos += textureDefinition.length();
-    }
-	
-    QOpenGLShaderProgram *newShaderProgram = new QOpenGLShaderProgram(this);
-    bool hasError = false;
-    QString error = "";
-	
-    if(!hasError && !newShaderProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, defaultVertexShader)){
-        hasError = true;
-        error = newShaderProgram->log();
-
-        qWarning() << tr("Failed to compile default vertex shader.");
-	}
-    if(!hasError && !newShaderProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,fragmentShader)){
-        hasError = true;
-        error = newShaderProgram->log();
-		
-        if(fragmentShader == defaultFragmentShader)
-            qWarning() << tr("Failed to compile default shader.");
-        else if(shaderProgram == 0)
-            initShaders(defaultFragmentShader);
-    }
-    if(!hasError && !newShaderProgram->link()){
-        hasError = true;
-        error = newShaderProgram->log();
-		
-        if(fragmentShader == defaultFragmentShader)
-            qWarning() << tr("Failed to compile default shader.");
-        else if(shaderProgram == 0)
-            initShaders(defaultFragmentShader);
-    }
-    if(hasError){
-        delete newShaderProgram;
-
-        //mac  :<line>:
-        //mesa :<line>(<errorcode>):
-        QRegExp errorline(":([0-9]+)(\\([0-9]+\\))?:");
-        if(errorline.indexIn(error) > -1){
-            QString text = errorline.cap(1);
-            if(text.toInt()-3 > 0)  // because: "#define lowp", "#define mediump" and "#define highp"
-                Q_EMIT errored(error, text.toInt()-3);
+/**
+ * @brief Renderer::useShader
+ * @param compiled Result of a compilation; the renderer takes ownership
+ * @return True if the shader is used from now on, otherwise false
+ *
+ * Replace the current program by a compiled one and bind its
+ * inputs. Failed compilations are reported and leave the current
+ * program in place; if there is none, the default shader is used.
+ * A replaced program the watchdog trusts is kept as the fallback
+ * for programs that turn out too expensive.
+ */
+bool Renderer::useShader(CompiledShader *compiled){
+    if(!compiled->program){
+        Q_EMIT errored(compiled->error, compiled->errorLine);
+        // literals can be patched into the program on screen again
+        if(compiled->skeleton == queuedSkeleton)
+            queuedSkeleton = shader ? shader->skeleton : QString();
+        delete compiled;
+        if(!shader){
+            compiled = ShaderCompiler::compile(currentFile, ShaderCompiler::defaultFragmentShader);
+            if(compiled->program)
+                useShader(compiled);
             else
-                Q_EMIT errored(error, text.toInt());
+                delete compiled;
         }
         return false;
     }
 
-    QList<QOpenGLTexture*> newTextures;
-    for(const QPair<QString, QString> image: images){
-
-        QOpenGLTexture* texture = new QOpenGLTexture(QImage(image.second));
-
-        texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-        texture->setMagnificationFilter(QOpenGLTexture::Linear);
-
-        //qDebug() << imageName << " from " << imagePath << ": " << texture->textureId() << " (" << texture << ")";
-
-        newTextures.append(texture);
+    if(shader && watchdog.isTrusted()){
+        delete goodShader;
+        goodShader = shader;
+    }else{
+        delete shader;
     }
+    shader = compiled;
+    watchdog.reset();
+    if(resolutionReduced){
+        resolution.setFixedScale(resolutionScale);
+        resolutionReduced = false;
+    }
+    QOpenGLShaderProgram *shaderProgram = shader->program.data();
+    shaderProgram->bind();
+    vao->bind();
 
-    shaderProgramMutex.lock();
+    // the locations are bound on link; vertex passes have no attributes to look them up
+    vertexAttr   = 0;
+    glBindBuffer(GL_ARRAY_BUFFER, resources->vertexBuffer());
+    shaderProgram->setAttributeBuffer(vertexAttr, GL_FLOAT, 0, 3);
+    shaderProgram->enableAttributeArray(vertexAttr);
+
+    uvAttr       = 1;
+    glBindBuffer(GL_ARRAY_BUFFER, resources->uvBuffer());
+    shaderProgram->setAttributeBuffer(uvAttr, GL_FLOAT, 0, 2);
+    shaderProgram->enableAttributeArray(uvAttr);
+
+    QList<RenderPass> previous;
+    previous.swap(passes);
+    for(const ShaderPass &shaderPass : shader->passes){
+        RenderPass pass;
+        pass.name = shaderPass.name;
+        pass.program = shaderPass.program.data();
+        pass.vertexCount = shaderPass.vertexCount;
+        pass.primitive = shaderPass.primitive;
+        pass.blending = shaderPass.blending;
+        for(int i = 0; i < 3; ++i)
+            pass.computeGroups[i] = shaderPass.computeGroups[i];
+        passes.append(pass);
+    }
 
-        if(shaderProgram){
-            shaderProgram->bind();
-            for(QOpenGLTexture *texture : textures){
-                texture->destroy();
-                delete texture;
-            }
-            delete shaderProgram;
+    const int bufferUnit = firstImageUnit + shader->textures.length();
+    bool usesLastPass = false;
+    for(int i = 0; i < passes.length(); ++i){
+        RenderPass &pass = passes[i];
+        QOpenGLShaderProgram *program = pass.program;
+        program->bind();
+
+        GLuint blockIndex = coreFunctions ?
+                coreFunctions->glGetUniformBlockIndex(program->programId(), ShaderCompiler::builtinBlockName) :
+                GL_INVALID_INDEX;
+        pass.builtinBlock = blockIndex != GL_INVALID_INDEX;
+        if(pass.builtinBlock){
+            coreFunctions->glUniformBlockBinding(program->programId(), blockIndex, builtinBinding);
+        }else{
+            pass.timeUniform       = program->uniformLocation("time");
+            pass.mouseUniform      = program->uniformLocation("mouse");
+            pass.rationUniform     = program->uniformLocation("ration");
+            pass.resolutionUniform = program->uniformLocation("resolution");
+            pass.historyRowUniform = program->uniformLocation("audioHistoryRow");
         }
-        textures = newTextures;
-        shaderProgram = newShaderProgram;
-        shaderProgram->bind();
+        pass.literalUniform = program->uniformLocation(ShaderLiterals::arrayName);
+
+        program->setUniformValue("audio", GLint(0));
+        program->setUniformValue("audioLeft", GLint(1));
+        program->setUniformValue("audioRight", GLint(2));
+        program->setUniformValue("audioSpectrumLeft", GLint(3));
+        program->setUniformValue("audioSpectrumRight", GLint(4));
+        program->setUniformValue("audioHistory", GLint(5));
+        const int end = shader->textures.length();
+        for(int j = 0; j < end; ++j)
+            program->setUniformValue(shader->textures[j].first.toLocal8Bit().data(), GLint(j + firstImageUnit));
+        for(int j = 0; j < passes.length(); ++j)
+            if(!passes[j].name.isEmpty())
+                program->setUniformValue(passes[j].name.toLocal8Bit().data(), GLint(bufferUnit + j));
+        program->setUniformValue("backbuffer", GLint(bufferUnit + passes.length()));
+
+        if(!legacyAudio && (program->uniformLocation("audioLeft") >= 0 ||
+                            program->uniformLocation("audioRight") >= 0))
+            createLegacyAudioTextures();
+        if(!spectrum && (program->uniformLocation("audioSpectrumLeft") >= 0 ||
+                         program->uniformLocation("audioSpectrumRight") >= 0))
+            createSpectrumTextures();
+        if(!audioHistory && program->uniformLocation("audioHistory") >= 0)
+            createAudioHistoryTexture();
+
+        if(!passes.last().name.isEmpty() && program->uniformLocation(passes.last().name.toLocal8Bit().data()) >= 0)
+            usesLastPass = true;
+    }
 
-        vertexAttr   = shaderProgram->attributeLocation("position");
-        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
-        shaderProgram->setAttributeBuffer(vertexAttr, GL_FLOAT, 0, 3);
-        shaderProgram->enableAttributeArray(vertexAttr);
+    // every pass but the last is read by others; the last only needs buffers if it is read back
+    for(int i = 0; i < passes.length(); ++i){
+        RenderPass &pass = passes[i];
+        pass.feedback = pass.computeGroups[0] == 0 && (i + 1 < passes.length() || usesLastPass ||
+                pass.program->uniformLocation("backbuffer") >= 0);
+        if(!pass.feedback)
+            continue;
+        for(RenderPass &old : previous)
+            if(old.feedback && old.name == pass.name && old.buffers[0]){
+                pass.buffers[0] = old.buffers[0];
+                pass.buffers[1] = old.buffers[1];
+                old.buffers[0] = old.buffers[1] = 0;
+                break;
+            }
+    }
+    for(RenderPass &old : previous)
+        releaseBuffers(old);
+    updateStorageBuffers();
+
+    // values set in the editor stay while the uniform is declared, edited defaults apply otherwise
+    QList<ShaderParameter> previousParameters;
+    previousParameters.swap(parameters);
+    for(ShaderParameter parameter : shader->parameters){
+        for(const ShaderParameter &old : previousParameters)
+            if(old.name == parameter.name && old.value != old.defaultValue)
+                parameter.value = parameter.clamp(old.value);
+        parameters.append(parameter);
+        for(RenderPass &pass : passes)
+            pass.parameterUniforms.append(pass.program->uniformLocation(parameter.name));
+    }
+    Q_EMIT parametersChanged(parameters);
+    literals = ShaderLiterals::pack(shader->literals);
 
-        uvAttr       = shaderProgram->attributeLocation("texCoord");
-        glBindBuffer(GL_ARRAY_BUFFER, uvBuffer);
-        shaderProgram->setAttributeBuffer("texCoord", GL_FLOAT, 0, 2);
-        shaderProgram->enableAttributeArray(uvAttr);
+    // a progressive image of the old passes can not be finished
+    tileIndex = 0;
+    samples = 0;
+    accumulated = false;
 
-        timeUniform   = shaderProgram->uniformLocation("time");
-        mouseUniform  = shaderProgram->uniformLocation("mouse");
-        rationUniform = shaderProgram->uniformLocation("ration");
+    // the sections of the measured frames refer to the old passes
+    gpuTimer.reset();
+    gpuTimes.clear();
+    statistics.gpuFrames = 0;
+    statistics.passTimes.clear();
 
-        shaderProgram->setUniformValue("audioLeft", GLint(0));
-        shaderProgram->setUniformValue("audioRight", GLint(1));
-        const int end = images.length();
-        for(int i = 0; i < end; ++i)
-            shaderProgram->setUniformValue(images[i].first.toLocal8Bit().data(), GLint(i + 2));
+    vao->release();
 
-        fragmentSource = fragmentShader;
-    shaderProgramMutex.unlock();
+    fragmentSource = shader->code;
 
 //    qDebug() << "vertexAttr" << vertexAttr;
 //    qDebug() << "uvAttr" << uvAttr;
@@ -308,240 +737,1073 @@ bool Renderer::initShaders(QString fragmentShader){
 /**
  * @brief Renderer::render
  *
- * Initialize output device, execute the shader and display the result
+ * Execute the shader with the state of the window and display the result
  */
 void Renderer::render(){
-    if(!device)
-        device = new QOpenGLPaintDevice();
+//    qDebug() << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_VERSION))) << " " << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)));
+    render(window->pixelSize(), timeline.milliseconds(), window->mousePosition());
+}
 
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+/**
+ * @brief Renderer::render
+ * @param viewport Size of the render target in pixels
+ * @param currentTime Value of the time uniform in milliseconds
+ * @param mousePosition Value of the mouse uniform
+ *
+ * Execute the shader on the currently bound framebuffer. If the
+ * resolution is scaled down, the shader is drawn into an offscreen
+ * target of the scaled size that is upscaled to the framebuffer.
+ */
+void Renderer::render(const QSize &viewport, double currentTime, const QVector2D &mousePosition){
+    if(passes.isEmpty())
+        return;
+    if(progressiveTiles > 1){
+        renderProgressive(viewport, currentTime, mousePosition);
+        return;
+    }
 
-    device->setSize(size());
+    QSize size = resolution.scaledSize(viewport);
+    updateBuiltins(size, currentTime, mousePosition);
+    if(size == viewport){
+        renderPasses(viewport);
+        return;
+    }
 
-//    qDebug() << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_VERSION))) << " " << QLatin1String(reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION)));
-    const qreal retinaScale = devicePixelRatio();
-    glViewport(0, 0, width() * retinaScale, height() * retinaScale);
+    GLint target = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &target);
+    if(!scaledTarget || scaledTarget->size() != size){
+        delete scaledTarget;
+        scaledTarget = new QOpenGLFramebufferObject(size);
+        glBindTexture(GL_TEXTURE_2D, scaledTarget->texture());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    scaledTarget->bind();
+    renderPasses(size);
 
-    glClear(GL_COLOR_BUFFER_BIT);
+    gpuTimer.begin(passes.length());
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glViewport(0, 0, viewport.width(), viewport.height());
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    copyTexture(scaledTarget->texture(), viewport);
+    gpuTimer.end();
+}
+
+/**
+ * @brief Renderer::updateBuiltins
+ * @param viewport Size the passes are drawn at in pixels
+ * @param currentTime Value of the time uniform in milliseconds
+ * @param mousePosition Value of the mouse uniform
+ *
+ * Compute the built-in uniforms of the frame and upload them
+ * to the uniform block with a single buffer update
+ */
+void Renderer::updateBuiltins(const QSize &viewport, double currentTime, const QVector2D &mousePosition){
+    const double seconds = std::floor(currentTime / 1000);
+    // whole seconds are exact in a float below 2^24, so they wrap there
+    builtins.resolution[0] = viewport.width();
+    builtins.resolution[1] = viewport.height();
+    builtins.mouse[0] = mousePosition.x();
+    builtins.mouse[1] = mousePosition.y();
+    builtins.time = GLfloat(currentTime);
+    builtins.deltaTime = lastRenderTime < 0 ? 0 : GLfloat(currentTime - lastRenderTime);
+    builtins.timeSeconds = GLfloat(std::fmod(seconds, 16777216.0));
+    builtins.timeFraction = GLfloat(currentTime / 1000 - seconds);
+    builtins.ration = viewport.height() == 0 ? 1 : GLfloat(viewport.width()) / viewport.height();
+    builtins.aspect = builtins.ration;
+    builtins.frame = frameIndex++;
+    builtins.audioHistoryRow = audioHistoryRow;
+    lastRenderTime = currentTime;
+
+    for(const RenderPass &pass : passes)
+        if(pass.builtinBlock){
+            glBindBuffer(GL_UNIFORM_BUFFER, builtinBuffer);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(builtins), &builtins);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            break;
+        }
+}
+
+/**
+ * @brief Renderer::renderPasses
+ * @param viewport Size of the render target in pixels
+ *
+ * Draw all passes of the shader; the image ends up
+ * in the currently bound framebuffer. Each pass is a
+ * section of the GPU timer.
+ */
+void Renderer::renderPasses(const QSize &viewport){
+    if(passes.isEmpty())
+        return;
 
-    QPoint mouse = this->mapFromGlobal(QCursor::pos());
-    QVector2D mousePosition((float)mouse.x() / (float)this->width(),
-                            (float)mouse.y() / (float)this->height());
-    float ration = ((this->height() == 0) ? 1 : (float)this->width() / (float)this->height());
+    GLint target = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &target);
+    const bool feedback = updateBuffers(viewport);
 
-    shaderProgramMutex.lock();
-        shaderProgram->bind();
-        vao->bind();
+    vao->bind();
+    bindInputs();
+    for(int i = 0; i < passes.length(); ++i){
+        gpuTimer.begin(i);
+        drawPass(i, viewport, target);
+        // the last pass is timed including the copy of its buffer
+        if(i + 1 < passes.length())
+            gpuTimer.end();
+    }
+    vao->release();
 
+    const RenderPass &image = passes.last();
+    if(image.feedback){
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        copyTexture(image.buffers[bufferIndex]->texture(), viewport);
+    }
+    gpuTimer.end();
+    if(feedback)
+        bufferIndex = 1 - bufferIndex;
+}
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
+/**
+ * @brief Renderer::bindInputs
+ *
+ * Bind the audio textures and the images of the shader
+ * to the texture units its samplers were assigned and the
+ * storage buffers to their binding points. Storage buffers
+ * are cleared here if the timeline was restarted.
+ */
+void Renderer::bindInputs(){
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_1D, audioTextures.audio);
 
+    if(legacyAudio){
         glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_1D, audioRightTexture);
+        glBindTexture(GL_TEXTURE_1D, audioTextures.left);
+
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_1D, audioTextures.right);
+    }
+
+    if(spectrum){
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_1D, spectrumLeftTexture);
+
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_1D, spectrumRightTexture);
+    }
+
+    if(audioHistory){
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_2D, audioHistoryTexture);
+    }
 
-        for(int i = 0; i < textures.length(); ++i){
-            glActiveTexture(GL_TEXTURE0 + 2 + i);
-            textures[i]->bind();
+    for(int i = 0; i < shader->textures.length(); ++i){
+        glActiveTexture(GL_TEXTURE0 + firstImageUnit + i);
+        glBindTexture(GL_TEXTURE_2D, shader->textures[i].second->id);
+    }
+
+    if(!computeFunctions)
+        return;
+    for(int i = 0; i < storageBuffers.length(); ++i){
+        computeFunctions->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, storageBuffers[i].buffer);
+        if(clearStorage && storageBuffers[i].buffer)
+            computeFunctions->glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R8, GL_RED, GL_UNSIGNED_BYTE, 0);
+    }
+    clearStorage = false;
+}
+
+/**
+ * @brief Renderer::drawPass
+ * @param index Index of the pass
+ * @param viewport Size of the render target in pixels
+ * @param target Framebuffer the image is drawn into if the pass has no buffers
+ *
+ * Draw a pass with the quad of the bound vertex array. The scissor
+ * box is respected, so a pass can be drawn tile by tile. Vertex
+ * passes draw their vertices without buffers onto a cleared
+ * target, blended as their directive asks. Compute passes are
+ * dispatched instead and draw nothing; the passes after them
+ * see everything they wrote into storage buffers.
+ */
+void Renderer::drawPass(int index, const QSize &viewport, GLuint target){
+    // passes before the current one are read from this frame, the others from the last one
+    const int bufferUnit = firstImageUnit + shader->textures.length();
+    const int backbufferUnit = bufferUnit + passes.length();
+    const int write = bufferIndex, read = 1 - bufferIndex;
+    RenderPass &pass = passes[index];
+    for(int j = 0; j < passes.length(); ++j){
+        if(!passes[j].feedback)
+            continue;
+        glActiveTexture(GL_TEXTURE0 + bufferUnit + j);
+        glBindTexture(GL_TEXTURE_2D, passes[j].buffers[j < index ? write : read]->texture());
+    }
+
+    if(pass.feedback){
+        glActiveTexture(GL_TEXTURE0 + backbufferUnit);
+        glBindTexture(GL_TEXTURE_2D, pass.buffers[read]->texture());
+        pass.buffers[write]->bind();
+        // the quad covers the whole buffer, the vertices of a vertex pass may not
+        if(pass.vertexCount > 0){
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glClearColor(0, 0, 0.3, 1);
         }
+    }else if(pass.computeGroups[0] == 0){
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    }
+    glViewport(0, 0, viewport.width(), viewport.height());
 
-        shaderProgram->setUniformValue(mouseUniform, mousePosition);
-        shaderProgram->setUniformValue(rationUniform, ration);
-        shaderProgram->setUniformValue(timeUniform, GLfloat(time->elapsed()));
+    QOpenGLShaderProgram *shaderProgram = pass.program;
+    shaderProgram->bind();
+    if(!pass.builtinBlock){
+        shaderProgram->setUniformValue(pass.mouseUniform, builtins.mouse[0], builtins.mouse[1]);
+        shaderProgram->setUniformValue(pass.rationUniform, builtins.ration);
+        shaderProgram->setUniformValue(pass.timeUniform, builtins.time);
+        shaderProgram->setUniformValue(pass.resolutionUniform, builtins.resolution[0], builtins.resolution[1]);
+        if(pass.historyRowUniform >= 0)
+            shaderProgram->setUniformValue(pass.historyRowUniform, builtins.audioHistoryRow);
+    }
+    for(int i = 0; i < pass.parameterUniforms.size(); ++i){
+        if(pass.parameterUniforms[i] < 0)
+            continue;
+        if(parameters[i].type == ShaderParameter::Int)
+            shaderProgram->setUniformValue(pass.parameterUniforms[i], GLint(parameters[i].value));
+        else
+            shaderProgram->setUniformValue(pass.parameterUniforms[i], GLfloat(parameters[i].value));
+    }
+    if(pass.literalUniform >= 0)
+        shaderProgram->setUniformValueArray(pass.literalUniform, literals.constData(), literals.size() / 4, 4);
 
+    if(pass.computeGroups[0] > 0){
+        if(computeFunctions){
+            computeFunctions->glDispatchCompute(pass.computeGroups[0], pass.computeGroups[1], pass.computeGroups[2]);
+            computeFunctions->glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+        return;
+    }
+    if(pass.vertexCount == 0){
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        return;
+    }
 
-        vao->release();
-    shaderProgramMutex.unlock();
+    if(pass.blending != ShaderPass::Opaque){
+        glEnable(GL_BLEND);
+        if(pass.blending == ShaderPass::Additive)
+            glBlendFunc(GL_ONE, GL_ONE);
+        else
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+    pointVao->bind();
+    glDrawArrays(pass.primitive, 0, pass.vertexCount);
+    pointVao->release();
+    vao->bind();
+    glDisable(GL_BLEND);
+}
+
+/**
+ * @brief Renderer::renderProgressive
+ * @param viewport Size of the window in pixels
+ * @param currentTime Time of the shader in milliseconds
+ * @param mousePosition Normalized mouse position
+ *
+ * Draw the next tile of the current image and show the last
+ * complete one. Tiles are drawn pass by pass, so every pass still
+ * reads complete buffers of the passes before it, and one tile per
+ * call keeps each draw call short. Time and mouse are taken when
+ * an image is started. Finished images are blended into the
+ * accumulation target; while accumulation is on and neither the
+ * time, the mouse nor the size changed, each image adds a sample
+ * to the average, otherwise it replaces it. Shaders can vary
+ * their samples with the frame counter.
+ */
+void Renderer::renderProgressive(const QSize &viewport, double currentTime, const QVector2D &mousePosition){
+    GLint target = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &target);
+    if(!sampleTarget || sampleTarget->size() != viewport){
+        delete sampleTarget;
+        delete accumulationTarget;
+        QOpenGLFramebufferObjectFormat format;
+        format.setInternalTextureFormat(GL_RGBA16F);
+        sampleTarget = new QOpenGLFramebufferObject(viewport, format);
+        accumulationTarget = new QOpenGLFramebufferObject(viewport, format);
+        sampleTarget->bind();
+        glClear(GL_COLOR_BUFFER_BIT);
+        tileIndex = 0;
+        samples = 0;
+        accumulated = false;
+    }
+
+    if(tileIndex == 0){
+        if(!accumulate || currentTime != sampleTime || mousePosition != sampleMouse)
+            samples = 0;
+        sampleTime = currentTime;
+        sampleMouse = mousePosition;
+        updateBuiltins(viewport, currentTime, mousePosition);
+        updateBuffers(viewport);
+    }
+
+    const int tiles = progressiveTiles * progressiveTiles;
+    const int pass = tileIndex / tiles, tile = tileIndex % tiles;
+    const int column = tile % progressiveTiles, row = tile / progressiveTiles;
+    const int left = viewport.width() * column / progressiveTiles;
+    const int bottom = viewport.height() * row / progressiveTiles;
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(left, bottom,
+              viewport.width() * (column + 1) / progressiveTiles - left,
+              viewport.height() * (row + 1) / progressiveTiles - bottom);
+
+    vao->bind();
+    bindInputs();
+    gpuTimer.begin(pass);
+    // compute passes update their buffers once per image, not once per tile
+    if(passes[pass].computeGroups[0] == 0 || tile == 0)
+        drawPass(pass, viewport, sampleTarget->handle());
+    gpuTimer.end();
+    vao->release();
+    glDisable(GL_SCISSOR_TEST);
+
+    if(++tileIndex == tiles * passes.length()){
+        tileIndex = 0;
+        const RenderPass &image = passes.last();
+        if(image.feedback){
+            sampleTarget->bind();
+            copyTexture(image.buffers[bufferIndex]->texture(), viewport);
+        }
+        for(const RenderPass &renderPass : passes)
+            if(renderPass.feedback){
+                bufferIndex = 1 - bufferIndex;
+                break;
+            }
+
+        accumulationTarget->bind();
+        glEnable(GL_BLEND);
+        glBlendColor(0, 0, 0, 1.0f / (samples + 1));
+        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+        copyTexture(sampleTarget->texture(), viewport);
+        glDisable(GL_BLEND);
+        ++samples;
+        accumulated = true;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glViewport(0, 0, viewport.width(), viewport.height());
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+    copyTexture(accumulated ? accumulationTarget->texture() : sampleTarget->texture(), viewport);
+}
+
+/**
+ * @brief Renderer::copyTexture
+ * @param texture Texture to draw
+ * @param viewport Size of the bound framebuffer in pixels
+ *
+ * Stretch a texture over the bound framebuffer, filtered linearly
+ */
+void Renderer::copyTexture(GLuint texture, const QSize &viewport){
+    vao->bind();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    copyProgram->bind();
+    copyProgram->setUniformValue("targetSize", QVector2D(viewport.width(), viewport.height()));
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    vao->release();
+}
+
+/**
+ * @brief Renderer::updateBuffers
+ * @param viewport Size of the render target in pixels
+ * @return True if any pass renders into buffers
+ *
+ * Create the buffers of the passes that need them and resize
+ * them with the viewport. New buffers start out transparent black.
+ */
+bool Renderer::updateBuffers(const QSize &viewport){
+    bool feedback = false;
+    for(RenderPass &pass : passes){
+        if(!pass.feedback)
+            continue;
+        feedback = true;
+        if(pass.buffers[0] && pass.buffers[0]->size() == viewport)
+            continue;
+
+        releaseBuffers(pass);
+        QOpenGLFramebufferObjectFormat format;
+        format.setInternalTextureFormat(GL_RGBA16F);
+        for(QOpenGLFramebufferObject *&buffer : pass.buffers){
+            buffer = new QOpenGLFramebufferObject(viewport, format);
+            glBindTexture(GL_TEXTURE_2D, buffer->texture());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            buffer->bind();
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        glClearColor(0, 0, 0.3, 1);
+    }
+    return feedback;
+}
+
+/**
+ * @brief Renderer::releaseBuffers
+ * @param pass Pass whose buffers are freed
+ */
+void Renderer::releaseBuffers(RenderPass &pass){
+    for(QOpenGLFramebufferObject *&buffer : pass.buffers){
+        delete buffer;
+        buffer = 0;
+    }
+}
+
+/**
+ * @brief Renderer::updateStorageBuffers
+ *
+ * Allocate the storage buffers the current shader declares. The
+ * size of an element is asked from a program that uses the buffer;
+ * buffers no program uses are not allocated. Buffers of the last
+ * shader with the same name and size are kept with their contents,
+ * new ones start out zeroed.
+ */
+void Renderer::updateStorageBuffers(){
+    QList<StorageBuffer> previous;
+    previous.swap(storageBuffers);
+    for(const QPair<QString, int> &declared : shader->storageBuffers){
+        StorageBuffer storage;
+        storage.name = declared.first;
+        const QByteArray blockName = (declared.first + "Buffer").toLocal8Bit();
+        for(int i = 0; computeFunctions && i < passes.length() && storage.size == 0; ++i){
+            GLuint block = computeFunctions->glGetProgramResourceIndex(passes[i].program->programId(),
+                                                                      GL_SHADER_STORAGE_BLOCK, blockName.data());
+            if(block == GL_INVALID_INDEX)
+                continue;
+            // the size of a block with only a runtime sized array is the size of one element
+            const GLenum property = GL_BUFFER_DATA_SIZE;
+            GLint elementSize = 0;
+            computeFunctions->glGetProgramResourceiv(passes[i].program->programId(), GL_SHADER_STORAGE_BLOCK,
+                                                     block, 1, &property, 1, 0, &elementSize);
+            storage.size = GLsizeiptr(elementSize) * declared.second;
+        }
+
+        for(StorageBuffer &old : previous)
+            if(old.buffer && old.name == storage.name && old.size == storage.size){
+                storage.buffer = old.buffer;
+                old.buffer = 0;
+                break;
+            }
+        if(!storage.buffer && storage.size > 0){
+            // older errors must not hide or pose as a failed allocation; a lost context never runs out of them
+            for(int i = 0; i < 16 && glGetError() != GL_NO_ERROR; ++i)
+                ;
+            computeFunctions->glGenBuffers(1, &storage.buffer);
+            computeFunctions->glBindBuffer(GL_SHADER_STORAGE_BUFFER, storage.buffer);
+            computeFunctions->glBufferData(GL_SHADER_STORAGE_BUFFER, storage.size, 0, GL_DYNAMIC_COPY);
+            computeFunctions->glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R8, GL_RED, GL_UNSIGNED_BYTE, 0);
+            computeFunctions->glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            if(glGetError() == GL_OUT_OF_MEMORY){
+                computeFunctions->glDeleteBuffers(1, &storage.buffer);
+                storage.buffer = 0;
+                Q_EMIT errored(tr("Not enough memory for the storage buffer %1.").arg(storage.name), -1);
+            }
+        }
+        storageBuffers.append(storage);
+    }
+    for(StorageBuffer &old : previous)
+        if(old.buffer)
+            glDeleteBuffers(1, &old.buffer);
+}
+
+/**
+ * @brief Renderer::releaseStorageBuffers
+ *
+ * Free the storage buffers
+ */
+void Renderer::releaseStorageBuffers(){
+    for(StorageBuffer &storage : storageBuffers)
+        if(storage.buffer)
+            glDeleteBuffers(1, &storage.buffer);
+    storageBuffers.clear();
 }
 
 /**
  * @brief Renderer::renderLater
  *
- * Enqueue an update event to event queue
+ * Enqueue a new frame in the render loop. Multiple
+ * requests before the next frame are merged into one.
  */
 void Renderer::renderLater(){
-    if(!pendingUpdate){
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
-        pendingUpdate = true;
+    if(context && !frameTimer.isActive())
+        frameTimer.start(0);
+}
+
+/**
+ * @brief Renderer::toggleTimeline
+ *
+ * Pause the time of the shader or let it run again
+ */
+void Renderer::toggleTimeline(){
+    timeline.togglePause();
+    renderLater();
+}
+
+/**
+ * @brief Renderer::seekTimeline
+ * @param offset Milliseconds to move the time of the shader by; negative to go back
+ */
+void Renderer::seekTimeline(qreal offset){
+    timeline.seek(timeline.milliseconds() + offset);
+    renderLater();
+}
+
+/**
+ * @brief Renderer::restartTimeline
+ *
+ * Move the time of the shader back to 0
+ */
+void Renderer::restartTimeline(){
+    timeline.seek(0);
+    clearStorage = true;
+    renderLater();
+}
+
+/**
+ * @brief Renderer::scaleTimelineSpeed
+ * @param factor Factor the speed of the time of the shader is multiplied with
+ */
+void Renderer::scaleTimelineSpeed(qreal factor){
+    timeline.setSpeed(qBound(1.0 / 64, timeline.speed() * factor, 64.0));
+    renderLater();
+}
+
+/**
+ * @brief Renderer::fallBack
+ * @param measure What was measured, for the report
+ *
+ * React to a program that overran the frame budget of the watchdog:
+ * go back to the last trusted program if there is one, otherwise
+ * draw at the lowest resolution first and use the default shader
+ * if that does not help either. The reason is reported through
+ * errored(). Once the program is replaced, the compiler compiles
+ * the same code again if it is run again. Requires a current context.
+ */
+void Renderer::fallBack(const QString &measure){
+    QString reason = tr("The %1 exceeded the budget of %2 ms for %3 frames in a row (up to %4 ms). ")
+            .arg(measure).arg(watchdog.budget()).arg(watchdog.limit()).arg(watchdog.worstTime(), 0, 'f', 0);
+    if(goodShader){
+        CompiledShader *fallback = goodShader;
+        goodShader = 0;
+        useShader(fallback);
+        if(compiler)
+            compiler->forgetLastCode();
+        reason += tr("Reverted to the last program that kept it.");
+    }else if(!resolutionReduced && resolution.scale() > ResolutionController::minimumScale){
+        resolution.setFixedScale(ResolutionController::minimumScale);
+        resolutionReduced = true;
+        reason += tr("Reduced the resolution.");
+    }else{
+        initShaders(ShaderCompiler::defaultFragmentShader);
+        if(compiler)
+            compiler->forgetLastCode();
+        reason += tr("Reverted to the default shader.");
     }
+    Q_EMIT errored(reason, -1);
 }
 
 /**
- * @brief Renderer::renderNow
+ * @brief Renderer::toggleRecording
  *
- * Use the compiled shader to render on the widget
+ * Start streaming the presented frames to the recording
+ * target or stop a running recording
  */
-void Renderer::renderNow(){
-    pendingUpdate = false;
+void Renderer::toggleRecording(){
+    if(!context)
+        return;
+    context->makeCurrent(window);
+    if(recorder.isOpen())
+        stopRecording();
+    else
+        startRecording();
+}
 
-    if(!isExposed())
+/**
+ * @brief Renderer::recordingFailed
+ * @param message Description of the failure
+ *
+ * Stop a recording the writer could not continue
+ */
+void Renderer::recordingFailed(QString message){
+    if(context){
+        context->makeCurrent(window);
+        stopRecording();
+    }
+    Q_EMIT errored(message, -1);
+}
+
+/**
+ * @brief Renderer::startRecording
+ *
+ * Allocate the pixel buffers the frames are read back into and
+ * open the recording target for frames of the current window
+ * size. The frame rate announced in the stream is the fixed
+ * time step if there is one, otherwise the target frame rate.
+ * Requires OpenGL 3.3 and a current context.
+ */
+void Renderer::startRecording(){
+    if(!coreFunctions)
         return;
+    if(recordingTarget.isEmpty()){
+        Q_EMIT errored(tr("Choose a recording target in the render settings first."), -1);
+        return;
+    }
+
+    const QSize size = window->pixelSize();
+    glGenBuffers(3, readbackBuffers);
+    for(GLuint buffer : readbackBuffers){
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, 4 * size.width() * size.height(), 0, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackNext = readbackPending = 0;
+
+    const int rate = qRound(1000 / (timeline.fixedStep() > 0 ? timeline.fixedStep() : frameInterval()));
+    recorder.open(recordingTarget, size, rate);
+}
+
+/**
+ * @brief Renderer::stopRecording
+ *
+ * Hand over the frames that are still being read back, free
+ * the pixel buffers and close the recording target once all
+ * frames are written. Requires a current context.
+ */
+void Renderer::stopRecording(){
+    while(readbackPending > 0)
+        collectFrame(true);
+    glDeleteBuffers(3, readbackBuffers);
+    for(GLuint &buffer : readbackBuffers)
+        buffer = 0;
+    recorder.close();
+}
 
-    bool needsInit = false;
+/**
+ * @brief Renderer::readbackFrame
+ * @param size Size of the rendered frame
+ *
+ * Start reading the frame back into the next pixel buffer of a
+ * ring and hand over the frames the GPU has finished since. The
+ * copy runs on the GPU, so the frame usually arrives one frame
+ * later and the CPU only waits if the whole ring is still busy.
+ */
+void Renderer::readbackFrame(const QSize &size){
+    if(size != recorder.frameSize()){
+        stopRecording();
+        Q_EMIT errored(tr("Recording stopped because the window was resized."), -1);
+        return;
+    }
+    if(readbackPending == 3)
+        collectFrame(true);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[readbackNext]);
+    glReadPixels(0, 0, size.width(), size.height(), GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readbackFences[readbackNext] = coreFunctions->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readbackNext = (readbackNext + 1) % 3;
+    ++readbackPending;
+
+    while(readbackPending > 0 && collectFrame(false))
+        continue;
+}
 
-    if(!context){
-        context = new QOpenGLContext(this);
-        context->setFormat(requestedFormat());
-        context->create();
+/**
+ * @brief Renderer::collectFrame
+ * @param wait Wait for the GPU if the frame is not read back yet
+ * @return True if the oldest pending frame was handed over
+ *
+ * Copy the oldest frame that is being read back from
+ * its pixel buffer and hand it to the recorder
+ */
+bool Renderer::collectFrame(bool wait){
+    const int slot = (readbackNext - readbackPending + 3) % 3;
+    GLsync &fence = readbackFences[slot];
+    GLenum status = coreFunctions->glClientWaitSync(fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                                    wait ? GLuint64(1000000000) : 0);
+    if(!wait && status == GL_TIMEOUT_EXPIRED)
+        return false;
+    coreFunctions->glDeleteSync(fence);
+    fence = 0;
+    --readbackPending;
+
+    const QSize size = recorder.frameSize();
+    const int bytes = 4 * size.width() * size.height();
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readbackBuffers[slot]);
+    const void *pixels = coreFunctions->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if(pixels){
+        QByteArray frame = recorder.takeBuffer();
+        std::memcpy(frame.data(), pixels, bytes);
+        coreFunctions->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        recorder.push(frame);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
 
-        needsInit = true;
+/**
+ * @brief Renderer::scheduleFrame
+ *
+ * Enqueue the next frame. Presentation is paced by the
+ * swap interval; if a frame rate cap is set, the frame is
+ * delayed until it is due.
+ */
+void Renderer::scheduleFrame(){
+    if(frameRateCap > 0){
+        qint64 elapsed = (frameClock.nsecsElapsed() - lastFrameStart) / 1000000;
+        qint64 remaining = qint64(frameInterval()) - elapsed;
+        if(remaining > 0){
+            frameTimer.start(remaining);
+            return;
+        }
     }
+    frameTimer.start(0);
+}
 
-    context->makeCurrent(this);
+/**
+ * @brief Renderer::frameInterval
+ * @return Target time between two frames in milliseconds
+ *
+ * The interval is given by the frame rate cap or,
+ * if there is none, by the refresh rate of the screen.
+ */
+qreal Renderer::frameInterval(){
+    if(frameRateCap > 0)
+        return 1000.0 / frameRateCap;
+    if(window)
+        return 1000.0 / window->refreshRate();
+    return 1000.0 / 60;
+}
 
-    if(needsInit){
-        if (m_logger->initialize()){
-            m_logger->startLogging( QOpenGLDebugLogger::SynchronousLogging );
-            m_logger->enableMessages();
+/**
+ * @brief Renderer::recordFrame
+ * @param frameStart Start of the current frame in nanoseconds
+ *
+ * Add the duration of the last frame to the statistics and
+ * Q_EMIT frameStatistics about once per second.
+ */
+void Renderer::recordFrame(qint64 frameStart){
+    if(lastFrameStart >= 0){
+        double frameTime = (frameStart - lastFrameStart) / 1000000.0;
+        statistics.frameTime += frameTime;
+        statistics.maxFrameTime = qMax(statistics.maxFrameTime, frameTime);
+        if(frameTime > frameInterval() * 1.5)
+            ++statistics.missedDeadlines;
+        ++statistics.frames;
+        resolution.setTarget(frameInterval());
+        resolution.addFrame(frameTime);
+        if(!gpuTimer.isSupported() && shader && watchdog.addFrame(frameTime)){
+            context->makeCurrent(window);
+            fallBack(tr("frame time"));
+        }
+    }
+    lastFrameStart = frameStart;
+
+    if(statisticsClock.elapsed() >= 1000 && statistics.frames > 0){
+        statistics.frameTime /= statistics.frames;
+        statistics.interval = statisticsClock.elapsed();
+        statistics.resolutionScale = resolution.scale();
+        statistics.cpuTime = cpuTimes.percentile(0.5);
+        statistics.cpuTimeP95 = cpuTimes.percentile(0.95);
+        if(statistics.gpuFrames > 0){
+            statistics.gpuTime = gpuTimes.percentile(0.5);
+            statistics.gpuTimeP95 = gpuTimes.percentile(0.95);
+            statistics.gpuTimeP99 = gpuTimes.percentile(0.99);
+            for(double &passTime : statistics.passTimes)
+                passTime /= statistics.gpuFrames;
+            for(int i = 0; i < passes.length(); ++i)
+                statistics.passNames.append(passes[i].name.isEmpty() ? tr("pass %1").arg(i + 1) : passes[i].name);
+            statistics.passNames.append(tr("upscale"));
         }
-        initializeOpenGLFunctions();
-        init();
+        statistics.recording = recorder.isOpen();
+        statistics.droppedFrames = recorder.droppedFrames();
+        Q_EMIT frameStatistics(statistics);
+        statistics = FrameStatistics();
+        statisticsClock.restart();
     }
+}
 
+/**
+ * @brief Renderer::recordTimings
+ * @param frameStart Start of the current frame in nanoseconds
+ *
+ * Add the CPU time spent on the current frame and the GPU
+ * times of the frames the GPU finished in the meantime to
+ * the rolling windows and the statistics
+ */
+void Renderer::recordTimings(qint64 frameStart){
+    cpuTimes.add((frameClock.nsecsElapsed() - frameStart) / 1000000.0);
+
+    for(const QVector<double> &sections : gpuTimer.takeResults()){
+        double total = 0;
+        if(statistics.passTimes.size() < sections.size())
+            statistics.passTimes.resize(sections.size());
+        for(int i = 0; i < sections.size(); ++i){
+            total += sections[i];
+            statistics.passTimes[i] += sections[i];
+        }
+        gpuTimes.add(total);
+        ++statistics.gpuFrames;
+        if(watchdog.addFrame(total)){
+            // the remaining results belong to the program that is replaced now
+            fallBack(tr("GPU time"));
+            break;
+        }
+    }
+}
 
-    if(!shaderProgram)
+/**
+ * @brief Renderer::renderNow
+ *
+ * Take over the queued updates, use the compiled shader to
+ * render on the window and enqueue the next frame. The loop
+ * pauses while the window is hidden and is resumed by renderLater().
+ */
+void Renderer::renderNow(){
+    if(!context)
+        return;
+
+    if(!window->isRenderable()){
+        lastFrameStart = -1;
+        return;
+    }
+
+    if(!frameClock.isValid()){
+        frameClock.start();
+        statisticsClock.start();
+    }
+    const qint64 frameStart = frameClock.nsecsElapsed();
+    recordFrame(frameStart);
+
+    context->makeCurrent(window);
+
+    processQueues();
+
+    if(!shader)
         initShaders(fragmentSource);
 
-    if(shaderProgram)
+    timeline.update();
+    // one section per pass and one for upscaling
+    gpuTimer.beginFrame(passes.length() + 1);
+    if(shader)
         render();
+    gpuTimer.endFrame();
+    if(recorder.isOpen())
+        readbackFrame(window->pixelSize());
+    recordTimings(frameStart);
 
-    context->swapBuffers(this);
+    context->swapBuffers(window);
 
-    renderLater();
+    scheduleFrame();
 }
 
 /**
- * @brief Renderer::event
- * @param event The event that should be proccessed
- * @return True if the event was successful proccessed, otherwise false
+ * @brief Renderer::queueCode
+ * @param filename Name of the shader file
+ * @param code New shader program code
  *
- * Called if a new event is poped from the event-queue to render on update event
- * and Q_EMIT doneSignal on close event.
+ * Hand new code over to the render thread; it is passed to
+ * the compiler at the start of the next frame. Thread-safe.
  */
-bool Renderer::event(QEvent *event){
-    switch(event->type()){
-    case QEvent::UpdateRequest:
-        QCoreApplication::postEvent(this, new QEvent(QEvent::UpdateRequest));
-        renderNow();
-        return true;
-    case QEvent::Close:
-        Q_EMIT doneSignal(tr("User closed renderer"));
-        return true;
-    default:
-        return QWindow::event(event);
-    }
+void Renderer::queueCode(const QString &filename, const QString &code){
+    QMutexLocker locker(&queueMutex);
+    codeQueue.enqueue(QPair<QString, QString>(filename, code));
 }
 
 /**
- * @brief Renderer::exposeEvent
+ * @brief Renderer::queueSettings
+ * @param settings Settings of the owning instance
  *
- * Called if the window is ready to start rendering
+ * Hand new settings over to the render thread. Thread-safe.
  */
-void Renderer::exposeEvent(QExposeEvent *){
-    if(isExposed())
-        renderNow();
+void Renderer::queueSettings(const QHash<QString, QVariant> &settings){
+    QMutexLocker locker(&queueMutex);
+    settingsQueue.enqueue(settings);
 }
 
 /**
- * @brief Renderer::updateCode
- * @param filename Text for the title
- * @param code New shader program code
- * @return True on success, otherwise false.
+ * @brief Renderer::queueParameter
+ * @param name Name of an annotated uniform
+ * @param value New value of the uniform
  *
- * Set new title and compile new code for the shader program
+ * Hand a value set in the editor over to the render thread; it
+ * is written into the programs from the next frame on, without
+ * compiling. Thread-safe.
  */
-bool Renderer::updateCode(const QString &filename, const QString &code){
-    if(!initShaders(code))
-        return false;
-    currentFile = filename;
-    setTitle(filename);
-    show();
-    return true;
+void Renderer::queueParameter(const QString &name, float value){
+    QMutexLocker locker(&queueMutex);
+    parameterQueue.insert(name, value);
 }
 
 /**
- * @brief Renderer::updateAudioData
- * @param data New audio data
+ * @brief Renderer::processQueues
  *
- * Copy the new sound-data to the graphics memory for visualisation
+ * Apply everything that was handed over since the last frame.
+ * Only the newest code, settings and parameter values matter, since
+ * each of them replaces its predecessors. Code that differs from the
+ * shader on screen only in its float literals is not compiled; the
+ * new values are uploaded with the next frame. The latest audio is fetched from the
+ * audio input and uploaded if it changed. Programs the compiler
+ * finished in the meantime are swapped in here, between two frames.
  */
-void Renderer::updateAudioData(QByteArray data){
-    if(!shaderProgram)
+void Renderer::processQueues(){
+    QList<QPair<QString, QString>> codes;
+    QList<QHash<QString, QVariant>> settings;
+    QHash<QString, float> values;
+
+    queueMutex.lock();
+    codes.swap(codeQueue);
+    settings.swap(settingsQueue);
+    values.swap(parameterQueue);
+    queueMutex.unlock();
+
+    if(!settings.isEmpty())
+        applySettings(settings.last());
+    for(ShaderParameter &parameter : parameters){
+        if(!values.contains(parameter.name))
+            continue;
+        parameter.value = parameter.clamp(values.value(parameter.name));
+        // a progressive image is started anew with the new value
+        tileIndex = 0;
+        samples = 0;
+    }
+    if(!codes.isEmpty()){
+        currentFile = codes.last().first;
+        const QString &code = codes.last().second;
+        QVector<float> values;
+        const QString skeleton = ShaderLiterals::hoist(code, values);
+        // nothing but literals changed since the code on screen and the code being compiled
+        if(shader && shader->file == currentFile && shader->skeleton == skeleton && queuedSkeleton == skeleton){
+            shader->code = code;
+            shader->literals = values;
+            literals = ShaderLiterals::pack(values);
+            fragmentSource = code;
+            tileIndex = 0;
+            samples = 0;
+            if(compiler)
+                compiler->forgetLastCode();
+        }else{
+            queuedSkeleton = skeleton;
+            if(compiler)
+                compiler->queueCode(currentFile, code);
+            else
+                initShaders(code);
+        }
+    }
+    if(compiler)
+        for(CompiledShader *compiled : compiler->takeResults())
+            useShader(compiled);
+    uploadAudioData();
+}
+
+/**
+ * @brief Renderer::uploadAudioData
+ * @param force Upload the spectrum even if no new one was computed
+ *
+ * Fetch the audio textures the renderers share, which holds the
+ * latest audio frames interleaved in the RG audio texture and, if
+ * any shader needs them, planar in audioLeft and audioRight. The
+ * magnitude spectrum of this renderer goes into audioSpectrumLeft
+ * and audioSpectrumRight and each new spectrum also replaces the
+ * oldest row of audioHistory. The spectrum goes through the next
+ * pixel buffer of a ring, so the transfer does not wait for the
+ * frames still using the textures.
+ */
+void Renderer::uploadAudioData(bool force){
+    audioTextures = resources->audioTextures(coreFunctions, audioInput, legacyAudio);
+    if(!spectrum && !audioHistory)
         return;
-    GLenum type, internalType;
-    Q_UNUSED(internalType);
-    char typeSize;
-    switch(audio->format().sampleType() + audio->format().sampleSize()){
-        case  8: case 10:
-            type = GL_UNSIGNED_BYTE;
-            internalType = GL_R8UI;
-            typeSize = 1;
-            break;
-        case  9:
-            type = GL_BYTE;
-            internalType = GL_R8I;
-            typeSize = 1;
-            break;
-        case 16: case 18:
-            type = GL_UNSIGNED_SHORT;
-            internalType = GL_R16UI;
-            typeSize = 2;
-            break;
-        case 17:
-            type = GL_SHORT;
-            internalType = GL_R16I;
-            typeSize = 2;
-            break;
-        case 32: case 34:
-            type = GL_UNSIGNED_INT;
-            internalType = GL_R32UI;
-            typeSize = 4;
-            break;
-        case 33:
-            type = GL_INT;
-            internalType = GL_R32I;
-            typeSize = 4;
-            break;
-        case 35:
-            type = GL_FLOAT;
-            internalType = GL_R32F;
-            typeSize = 4;
-            break;
-        default: return;
-    }
-    char *left, *right;
-    int count = data.size();
-    if(audio->format().channelCount() == 2){
-        count /= 2;
-        left  = new char[count];
-        right = new char[count];
-        for(int i = 0; i < count; i += typeSize){
-            for(int j = 0; j < typeSize; ++j){
-                left [i+j] = data[i*2+j];
-                right[i+j] = data[i*2+j+typeSize];
-            }
+
+    float *spectrumLeft = audioWindow.data();
+    const int bins = spectrumSize / 2;
+    float *spectrumRight = spectrumLeft + bins;
+    float *historyRow = spectrumRight + bins;
+    bool spectrumChanged = false;
+    if(audioInput){
+        quint64 sequence = audioInput->readSpectrum(spectrumHandle, spectrumLeft, spectrumRight, bins);
+        spectrumChanged = sequence != spectrumSequence;
+        spectrumSequence = sequence;
+    }
+    if(!spectrumChanged && !force)
+        return;
+
+    int size = 2 * bins;
+    if(audioHistory && spectrumChanged){
+        for(int i = 0; i < bins; ++i){
+            historyRow[2*i]   = spectrumLeft[i];
+            historyRow[2*i+1] = spectrumRight[i];
         }
-    } else {
-        left = right = data.data();
+        size = 4 * bins;
     }
 
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, audioPixelBuffers[audioPixelBufferIndex]);
+    audioPixelBufferIndex = (audioPixelBufferIndex + 1) % 3;
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size * sizeof(float), spectrumLeft);
 
-    shaderProgramMutex.lock();
-    shaderProgram->bind();
+    if(spectrum){
+        glBindTexture(GL_TEXTURE_1D, spectrumLeftTexture);
+        glTexSubImage1D(GL_TEXTURE_1D, 0, 0, bins, GL_RED, GL_FLOAT, 0);
+
+        glBindTexture(GL_TEXTURE_1D, spectrumRightTexture);
+        glTexSubImage1D(GL_TEXTURE_1D, 0, 0, bins, GL_RED, GL_FLOAT,
+                        reinterpret_cast<const GLvoid*>(bins * sizeof(float)));
+    }
+
+    if(audioHistory && spectrumChanged){
+        audioHistoryRow = (audioHistoryRow + 1) % audioHistoryRows;
+        glBindTexture(GL_TEXTURE_2D, audioHistoryTexture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, audioHistoryRow, bins, 1, GL_RG, GL_FLOAT,
+                        reinterpret_cast<const GLvoid*>(2 * bins * sizeof(float)));
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
 
-    glBindTexture(GL_TEXTURE_1D, audioLeftTexture);
-    glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, count / typeSize, 0, GL_RED, type, left);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
 
-    glBindTexture(GL_TEXTURE_1D, audioRightTexture);
-    glTexImage1D(GL_TEXTURE_1D, 0, GL_R32F, count / typeSize, 0, GL_RED, type, right);
+/**
+ * @brief Renderer::applySettings
+ * @param settings Settings of the owning instance
+ *
+ * Apply the per-instance rendering settings.
+ */
+void Renderer::applySettings(const QHash<QString, QVariant> &settings){
+    frameRateCap = qMax(0, settings.value("FrameRateCap", 0).toInt());
+    int fixedRate = settings.value("FixedTimeStep", 0).toInt();
+    timeline.setFixedStep(fixedRate > 0 ? 1000.0 / fixedRate : 0);
+    timeline.setSpeed(settings.value("TimelineSpeed", 1.0).toDouble());
+    resolutionScale = settings.value("ResolutionScale", 0).toInt() / 100.0;
+    if(!resolutionReduced)
+        resolution.setFixedScale(resolutionScale);
+    watchdog.setBudget(settings.value("WatchdogBudget", 500).toInt());
+    watchdog.setLimit(settings.value("WatchdogFrames", 10).toInt());
+    int tiles = qBound(0, settings.value("ProgressiveTiles", 0).toInt(), 16);
+    if(tiles != progressiveTiles){
+        progressiveTiles = tiles;
+        tileIndex = 0;
+        samples = 0;
+        accumulated = false;
+    }
+    accumulate = settings.value("Accumulate", false).toBool();
+    recordingTarget = settings.value("RecordingTarget").toString();
 
-    shaderProgram->release();
-    shaderProgramMutex.unlock();
-    if(left != data.data())
-        delete[] left;
-    if(right != data.data())
-        delete[] right;
+    int size = SpectrumAnalyzer::roundSize(settings.value("SpectrumSize", 1024).toInt());
+    float smoothing = settings.value("SpectrumSmoothing", 0.8).toFloat();
+    if(size == spectrumSize && smoothing == spectrumSmoothing)
+        return;
+    bool resized = size != spectrumSize;
+    spectrumSize = size;
+    spectrumSmoothing = smoothing;
+    if(resized && audioHistory)
+        createAudioHistoryTexture();
+    if(resized && spectrum)
+        createSpectrumTextures();
+    else
+        updateSpectrumAnalysis();
 }
 
 /**
@@ -1,79 +1,273 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
-#include <QWindow>
-#include <QOpenGLPaintDevice>
+#include <QOpenGLContext>
 #include <QOpenGLFunctions>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QOpenGLFunctions_4_3_Core>
 #include <QOpenGLVertexArrayObject>
 #include <QOpenGLDebugLogger>
 #include <QOpenGLTexture>
-#include <QTime>
+#include <QOpenGLFramebufferObject>
+#include <QOffscreenSurface>
+#include <QColor>
+#include <QDebug>
+#include <QImage>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <QOpenGLShader>
 #include <QCoreApplication>
 #include <QDir>
 #include <QMutex>
+#include <QQueue>
+#include <cstring>
+#include <cmath>
 
+#include "RenderWindow.hpp"
 #include "AudioInputProcessor.hpp"
+#include "ShaderCompiler.hpp"
+#include "FrameStatistics.hpp"
+#include "ResolutionController.hpp"
+#include "GpuTimer.hpp"
+#include "TimingWindow.hpp"
+#include "Timeline.hpp"
+#include "ShaderWatchdog.hpp"
+#include "SharedResources.hpp"
+#include "FrameWriter.hpp"
+
+/**
+ * @brief The BuiltinUniforms struct
+ *
+ * The contents of the built-in uniform block that the
+ * ShaderCompiler declares, in std140 layout. Times are in
+ * milliseconds; timeSeconds and timeFraction split the time
+ * into whole seconds and the fraction of the current one, which
+ * keeps its precision in long sessions.
+ */
+struct BuiltinUniforms{
+    GLfloat resolution[2];
+    GLfloat mouse[2];
+    GLfloat time;
+    GLfloat deltaTime;
+    GLfloat timeSeconds;
+    GLfloat timeFraction;
+    GLfloat ration;
+    GLfloat aspect;
+    GLint frame;
+    GLint audioHistoryRow;
+};
+
+/**
+ * @brief The RenderPass struct
+ *
+ * A pass of the current shader as the renderer draws it: the
+ * program with its uniform locations and, if its output is read
+ * by a pass, two buffers that take turns being the target and
+ * holding the last frame. Passes that read the built-in uniform
+ * block have no locations of their own. parameterUniforms
+ * holds the location of each parameter of the shader and
+ * literalUniform the location of the hoisted literals.
+ */
+struct RenderPass{
+    RenderPass() :
+        program(0),
+        timeUniform(-1), mouseUniform(-1), rationUniform(-1),
+        resolutionUniform(-1), historyRowUniform(-1),
+        builtinBlock(false), feedback(false), literalUniform(-1),
+        vertexCount(0), primitive(GL_POINTS), blending(ShaderPass::Opaque)
+    {
+        buffers[0] = buffers[1] = 0;
+        computeGroups[0] = computeGroups[1] = computeGroups[2] = 0;
+    }
+    QString name;
+    QOpenGLShaderProgram *program;
+    GLint timeUniform, mouseUniform, rationUniform,
+        resolutionUniform, historyRowUniform;
+    bool builtinBlock;
+    bool feedback;
+    GLint literalUniform;
+    int vertexCount;
+    GLenum primitive;
+    ShaderPass::Blending blending;
+    int computeGroups[3];
+    QVector<GLint> parameterUniforms;
+    QOpenGLFramebufferObject *buffers[2];
+};
+
+/**
+ * @brief The StorageBuffer struct
+ *
+ * A shader storage buffer of the current shader; it outlives
+ * shaders that declare it with the same name and size
+ */
+struct StorageBuffer{
+    StorageBuffer() : size(0), buffer(0) { }
+    QString name;
+    GLsizeiptr size;
+    GLuint buffer;
+};
 
 /**
  * @brief The Renderer class
  *
- * A subclass of QWindow and QOPenGLFunctions that implements
- * a GLSL fragment shader renderer.
+ * A subclass of QObject and QOPenGLFunctions that implements
+ * a GLSL fragment shader renderer. It draws into a RenderWindow
+ * from the thread it lives on; code, audio data, settings and
+ * parameter values are handed over from other threads through
+ * queues. New code is compiled in the background by a
+ * ShaderCompiler, if one is set, while the current program stays
+ * on screen.
  */
-class Renderer : public QWindow, protected QOpenGLFunctions
+class Renderer : public QObject, protected QOpenGLFunctions
 {
     Q_OBJECT
 public:
-    explicit Renderer(QWindow *parent = 0);
-    explicit Renderer(const QString &, const QString &, QWindow *parent = 0);
+    explicit Renderer(QObject *parent = 0);
+    explicit Renderer(const QString &, const QString &, QObject *parent = 0);
     ~Renderer();
+    void setWindow(RenderWindow *);
+    void setCompiler(ShaderCompiler *);
+    void setAudioInput(AudioInputProcessor *);
+    bool exportFrames(const QSize &, int, qreal, const QString &);
+    void queueCode(const QString &, const QString &);
+    void queueSettings(const QHash<QString, QVariant> &);
+    void queueParameter(const QString &, float);
+    static QSurfaceFormat surfaceFormat();
 
 Q_SIGNALS:
-    void doneSignal(QString);
     void errored(QString, int);
+    void frameStatistics(FrameStatistics);
+    void parametersChanged(QList<ShaderParameter>);
 
 public Q_SLOTS:
+    void start();
+    void stop();
     void renderNow();
     void renderLater();
-    bool updateCode(const QString &, const QString &);
-    void updateAudioData(QByteArray);
+    void toggleTimeline();
+    void seekTimeline(qreal);
+    void restartTimeline();
+    void scaleTimelineSpeed(qreal);
+    void toggleRecording();
     void onMessageLogged(QOpenGLDebugMessage message);
 
-protected:
-    virtual bool event(QEvent *);
-    virtual void exposeEvent(QExposeEvent *);
+private Q_SLOTS:
+    void recordingFailed(QString);
 
 private:
+    bool initContext(QSurface *);
     bool init();
+    void release();
     void render();
-    bool initShaders(QString);
+    void render(const QSize &, double, const QVector2D &);
+    void renderPasses(const QSize &);
+    void renderProgressive(const QSize &, double, const QVector2D &);
+    void bindInputs();
+    void drawPass(int, const QSize &, GLuint);
+    void updateBuiltins(const QSize &, double, const QVector2D &);
+    void copyTexture(GLuint, const QSize &);
+    bool updateBuffers(const QSize &);
+    void releaseBuffers(RenderPass &);
+    void updateStorageBuffers();
+    void releaseStorageBuffers();
+    bool initShaders(const QString &);
+    bool useShader(CompiledShader *);
+    void processQueues();
+    void uploadAudioData(bool force = false);
+    void createLegacyAudioTextures();
+    void createSpectrumTextures();
+    void createAudioHistoryTexture();
+    void updateSpectrumAnalysis();
+    void applySettings(const QHash<QString, QVariant> &);
+    void scheduleFrame();
+    void recordFrame(qint64);
+    void recordTimings(qint64);
+    void fallBack(const QString &);
+    void startRecording();
+    void stopRecording();
+    void readbackFrame(const QSize &);
+    bool collectFrame(bool);
+    qreal frameInterval();
+    static bool writeFrame(const QImage &, int, const QString &);
     QString currentFile;
     QColor clearColor;
     QOpenGLContext *context;
-    QOpenGLPaintDevice *device;
-    QTime *time;
-    bool pendingUpdate;
+    QSurface *surface;
+    RenderWindow *window;
+    QOffscreenSurface *offscreenSurface;
+    Timeline timeline;
 
+    QTimer frameTimer;
+    QElapsedTimer frameClock, statisticsClock;
+    qint64 lastFrameStart;
+    int frameRateCap;
+    FrameStatistics statistics;
+    GpuTimer gpuTimer;
+    TimingWindow cpuTimes, gpuTimes;
+    ResolutionController resolution;
+    QOpenGLFramebufferObject *scaledTarget;
+    int progressiveTiles, tileIndex, samples;
+    bool accumulate, accumulated;
+    double sampleTime;
+    QVector2D sampleMouse;
+    QOpenGLFramebufferObject *sampleTarget, *accumulationTarget;
+
+    QString recordingTarget;
+    FrameWriter recorder;
+    GLuint readbackBuffers[3];
+    GLsync readbackFences[3];
+    int readbackNext, readbackPending;
+
+    QMutex queueMutex;
+    QQueue<QPair<QString, QString>> codeQueue;
+    QQueue<QHash<QString, QVariant>> settingsQueue;
+    QHash<QString, float> parameterQueue;
+
+    QOpenGLFunctions_3_3_Core *coreFunctions;
+    QOpenGLFunctions_4_3_Core *computeFunctions;
     QOpenGLVertexArrayObject *vao;
-    GLuint vertexBuffer, uvBuffer, audioLeftTexture, audioRightTexture;
-    GLint vertexAttr, uvAttr,
-        timeUniform, mouseUniform, rationUniform, samplerLeft, samplerRight;
-    QOpenGLShaderProgram *shaderProgram;
-    QMutex shaderProgramMutex;
+    QOpenGLVertexArrayObject *pointVao;
+    QSharedPointer<SharedResources> resources;
+    SharedResources::AudioTextures audioTextures;
+    GLuint spectrumLeftTexture, spectrumRightTexture, audioHistoryTexture;
+    GLuint audioPixelBuffers[3];
+    GLuint builtinBuffer;
+    BuiltinUniforms builtins;
+    int frameIndex;
+    double lastRenderTime;
+    int audioPixelBufferIndex;
+    bool legacyAudio, spectrum, audioHistory;
+    int spectrumSize, audioHistoryRow, spectrumHandle;
+    float spectrumSmoothing;
+    GLint vertexAttr, uvAttr;
+    CompiledShader *shader;
+    CompiledShader *goodShader;
+    ShaderWatchdog watchdog;
+    qreal resolutionScale;
+    bool resolutionReduced;
+    QList<RenderPass> passes;
+    int bufferIndex;
+    QList<StorageBuffer> storageBuffers;
+    bool clearStorage;
+    QList<ShaderParameter> parameters;
+    QVector<float> literals;
+    QString queuedSkeleton;
+    QOpenGLShaderProgram *copyProgram;
+    ShaderCompiler *compiler;
     QString fragmentSource;
-    QList<QOpenGLTexture*> textures;
 
-    AudioInputProcessor *audio;
+    AudioInputProcessor *audioInput;
+    quint64 spectrumSequence;
+    std::vector<float> audioWindow;
 
     QOpenGLDebugLogger* m_logger;
 
-    QRegExp textureRegEx;
-
 //    static bool mapFormat(float *target, char *source, int count, const QAudioFormat &format);
 //    template <typename T>
 //    static void convertArray(float *target, const T *source, int count, qreal div, qreal sub = 0);
-    static const char *defaultVertexShader, *defaultFragmentShader;
+    static const int audioHistoryRows;
+    static const int firstImageUnit;
+    static const GLuint builtinBinding;
 };
 
 #endif // RENDERER_HPP
@@ -0,0 +1,132 @@
+#include "ResolutionController.hpp"
+
+const qreal ResolutionController::minimumScale = 0.25;
+const qreal ResolutionController::scaleStep = 0.05;
+const int ResolutionController::windowFrames = 30;
+const int ResolutionController::calmWindows = 4;
+
+/**
+ * @brief ResolutionController::ResolutionController
+ *
+ * Create an automatic controller that targets 60 fps
+ */
+ResolutionController::ResolutionController() :
+    targetInterval(1000.0 / 60),
+    fixedScale(0),
+    currentScale(1),
+    frameTimeSum(0),
+    frames(0),
+    calm(0)
+{ }
+
+/**
+ * @brief ResolutionController::setTarget
+ * @param interval Frame interval to hold in milliseconds
+ */
+void ResolutionController::setTarget(qreal interval){
+    if(interval > 0)
+        targetInterval = interval;
+}
+
+/**
+ * @brief ResolutionController::setFixedScale
+ * @param scale Fraction of the resolution to draw at; 0 for automatic
+ *
+ * Changing the mode restarts the measurement.
+ */
+void ResolutionController::setFixedScale(qreal scale){
+    scale = scale > 0 ? qBound(minimumScale, scale, qreal(1)) : 0;
+    if(scale == fixedScale)
+        return;
+    fixedScale = scale;
+    reset();
+}
+
+/**
+ * @brief ResolutionController::isAutomatic
+ * @return True if the scale follows the frame times
+ */
+bool ResolutionController::isAutomatic() const{
+    return fixedScale == 0;
+}
+
+/**
+ * @brief ResolutionController::scale
+ * @return Fraction of the resolution to draw at, in [minimumScale, 1]
+ */
+qreal ResolutionController::scale() const{
+    return isAutomatic() ? currentScale : fixedScale;
+}
+
+/**
+ * @brief ResolutionController::scaledSize
+ * @param size Size of the render target in pixels
+ * @return Size to draw at; at least one pixel in each direction
+ */
+QSize ResolutionController::scaledSize(const QSize &size) const{
+    qreal factor = scale();
+    if(factor >= 1)
+        return size;
+    return QSize(qMax(1, qRound(size.width() * factor)), qMax(1, qRound(size.height() * factor)));
+}
+
+/**
+ * @brief ResolutionController::addFrame
+ * @param frameTime Time between the start of the last and this frame in milliseconds
+ * @return True if the scale changed
+ *
+ * Account a frame and adapt the scale at the end of a measuring window.
+ * Since the frame time grows with the pixel count, that is with the
+ * square of the scale, a missed target is met by scaling with the
+ * square root of the ratio of target and measured time.
+ */
+bool ResolutionController::addFrame(qreal frameTime){
+    if(!isAutomatic())
+        return false;
+
+    frameTimeSum += frameTime;
+    if(++frames < windowFrames)
+        return false;
+
+    qreal average = frameTimeSum / frames;
+    frameTimeSum = 0;
+    frames = 0;
+
+    if(average > targetInterval * 1.2){
+        calm = 0;
+        return setScale(qMin(currentScale * std::sqrt(targetInterval / average), currentScale - scaleStep));
+    }
+    if(average >= targetInterval * 1.05 || currentScale >= 1){
+        calm = 0;
+        return false;
+    }
+    if(++calm < calmWindows)
+        return false;
+    calm = 0;
+    return setScale(currentScale + scaleStep);
+}
+
+/**
+ * @brief ResolutionController::reset
+ *
+ * Restart the measurement at full resolution
+ */
+void ResolutionController::reset(){
+    currentScale = 1;
+    frameTimeSum = 0;
+    frames = 0;
+    calm = 0;
+}
+
+/**
+ * @brief ResolutionController::setScale
+ * @param scale New automatic scale
+ * @return True if the quantized scale differs from the current one
+ */
+bool ResolutionController::setScale(qreal scale){
+    scale = qBound(minimumScale, std::floor(scale / scaleStep + 0.5) * scaleStep, qreal(1));
+    if(qAbs(scale - currentScale) < scaleStep / 2)
+        return false;
+    currentScale = scale;
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef RESOLUTIONCONTROLLER_HPP
+#define RESOLUTIONCONTROLLER_HPP
+
+#include <QtGlobal>
+#include <QSize>
+#include <cmath>
+
+/**
+ * @brief The ResolutionController class
+ *
+ * Chooses the fraction of the window resolution a Renderer
+ * draws at. Either the scale is fixed, or it follows the
+ * measured frame times: if the average of a measuring window
+ * misses the target frame interval, the scale drops so that
+ * the pixel count fits the target; if frames have been on
+ * time for a while, it is raised again step by step. Scales
+ * are quantized to scaleStep, so the offscreen target is only
+ * reallocated on real changes.
+ */
+class ResolutionController
+{
+public:
+    ResolutionController();
+    void setTarget(qreal);
+    void setFixedScale(qreal);
+    bool isAutomatic() const;
+    qreal scale() const;
+    QSize scaledSize(const QSize &) const;
+    bool addFrame(qreal);
+    void reset();
+
+    static const qreal minimumScale, scaleStep;
+    static const int windowFrames, calmWindows;
+
+private:
+    bool setScale(qreal);
+
+    qreal targetInterval;
+    qreal fixedScale;
+    qreal currentScale;
+    qreal frameTimeSum;
+    int frames;
+    int calm;
+};
+
+#endif // RESOLUTIONCONTROLLER_HPP
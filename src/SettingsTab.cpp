@@ -308,3 +308,338 @@ void BehaviourTab::pythonSlot(bool toggled){
     settings->insert("RegularPythonDefault", toggled);
     Q_EMIT contentChanged();
 }
+
+/**
+ * @brief RenderTab::RenderTab
+ *
+ * Constructor of the RenderTab class.
+ * Calls addLayout().
+ */
+RenderTab::RenderTab(QHash<QString, QVariant> *Settings, QWidget* parent) : SettingsTab(Settings, parent){
+    addLayout();
+}
+
+/**
+ * @brief RenderTab::~RenderTab
+ *
+ * Destructor of the RenderTab class.
+ * Deletes the GUI elements.
+ */
+RenderTab::~RenderTab(){
+    delete frameRate;
+    delete resolution;
+    delete progressive;
+    delete watchdog;
+    delete spectrum;
+    delete timeline;
+    delete recording;
+}
+
+/**
+ * @brief RenderTab::addLayout
+ *
+ * Creates the render tab UI and makes it interactive.
+ */
+void RenderTab::addLayout(){
+    frameRate = new QGroupBox(tr("Frame Rate"));
+
+    frameRateLabel = new QLabel(tr("Frame rate cap:"));
+    frameRateBox = new QSpinBox;
+    frameRateBox->setRange(0, 240);
+    frameRateBox->setSuffix(tr(" fps"));
+    frameRateBox->setSpecialValueText(tr("Display refresh rate"));
+    frameRateBox->setValue(settings->value("FrameRateCap", 0).toInt());
+
+    connect(frameRateBox, SIGNAL(valueChanged(int)), this, SLOT(frameRateSlot(int)));
+
+    frameRateLayout = new QHBoxLayout;
+    frameRateLayout->addWidget(frameRateLabel);
+    frameRateLayout->addWidget(frameRateBox);
+    frameRate->setLayout(frameRateLayout);
+
+    resolution = new QGroupBox(tr("Resolution"));
+
+    resolutionLabel = new QLabel(tr("Render at:"));
+    resolutionBox = new QComboBox;
+    resolutionBox->addItem(tr("Automatic"), 0);
+    int scales[] = {100, 75, 50, 33, 25};
+    for(int scale : scales)
+        resolutionBox->addItem(tr("%1% of the window size").arg(scale), scale);
+    int resolutionIndex = resolutionBox->findData(settings->value("ResolutionScale", 0).toInt());
+    resolutionBox->setCurrentIndex(resolutionIndex < 0 ? 0 : resolutionIndex);
+
+    connect(resolutionBox, SIGNAL(currentIndexChanged(int)), this, SLOT(resolutionSlot(int)));
+
+    resolutionLayout = new QHBoxLayout;
+    resolutionLayout->addWidget(resolutionLabel);
+    resolutionLayout->addWidget(resolutionBox);
+    resolution->setLayout(resolutionLayout);
+
+    progressive = new QGroupBox(tr("Progressive Rendering"));
+
+    progressiveLabel = new QLabel(tr("Draw one tile per frame:"));
+    progressiveBox = new QComboBox;
+    progressiveBox->addItem(tr("Off"), 0);
+    for(int tiles = 2; tiles <= 8; tiles *= 2)
+        progressiveBox->addItem(tr("%1 x %1 tiles").arg(tiles), tiles);
+    int progressiveIndex = progressiveBox->findData(settings->value("ProgressiveTiles", 0).toInt());
+    progressiveBox->setCurrentIndex(progressiveIndex < 0 ? 0 : progressiveIndex);
+
+    accumulateBox = new QCheckBox(tr("Accumulate samples while the image is still"));
+    accumulateBox->setChecked(settings->value("Accumulate", false).toBool());
+
+    connect(progressiveBox, SIGNAL(currentIndexChanged(int)), this, SLOT(progressiveSlot(int)));
+    connect(accumulateBox, SIGNAL(stateChanged(int)), this, SLOT(accumulateSlot(int)));
+
+    progressiveLayout = new QVBoxLayout;
+    progressiveLayout->addWidget(progressiveLabel);
+    progressiveLayout->addWidget(progressiveBox);
+    progressiveLayout->addWidget(accumulateBox);
+    progressive->setLayout(progressiveLayout);
+
+    watchdog = new QGroupBox(tr("Watchdog"));
+
+    watchdogBudgetLabel = new QLabel(tr("Frame budget:"));
+    watchdogBudgetBox = new QSpinBox;
+    watchdogBudgetBox->setRange(0, 10000);
+    watchdogBudgetBox->setSingleStep(50);
+    watchdogBudgetBox->setSuffix(tr(" ms"));
+    watchdogBudgetBox->setSpecialValueText(tr("Off"));
+    watchdogBudgetBox->setValue(settings->value("WatchdogBudget", 500).toInt());
+
+    watchdogFramesLabel = new QLabel(tr("Fall back after:"));
+    watchdogFramesBox = new QSpinBox;
+    watchdogFramesBox->setRange(1, 600);
+    watchdogFramesBox->setSuffix(tr(" frames over budget"));
+    watchdogFramesBox->setValue(settings->value("WatchdogFrames", 10).toInt());
+
+    connect(watchdogBudgetBox, SIGNAL(valueChanged(int)), this, SLOT(watchdogBudgetSlot(int)));
+    connect(watchdogFramesBox, SIGNAL(valueChanged(int)), this, SLOT(watchdogFramesSlot(int)));
+
+    watchdogLayout = new QVBoxLayout;
+    watchdogLayout->addWidget(watchdogBudgetLabel);
+    watchdogLayout->addWidget(watchdogBudgetBox);
+    watchdogLayout->addWidget(watchdogFramesLabel);
+    watchdogLayout->addWidget(watchdogFramesBox);
+    watchdog->setLayout(watchdogLayout);
+
+    spectrum = new QGroupBox(tr("Audio Spectrum"));
+
+    spectrumSizeLabel = new QLabel(tr("FFT size:"));
+    spectrumSizeBox = new QComboBox;
+    for(int size = 256; size <= 4096; size *= 2)
+        spectrumSizeBox->addItem(tr("%1 samples").arg(size), size);
+    int sizeIndex = spectrumSizeBox->findData(settings->value("SpectrumSize", 1024).toInt());
+    spectrumSizeBox->setCurrentIndex(sizeIndex < 0 ? 2 : sizeIndex);
+
+    spectrumSmoothingLabel = new QLabel(tr("Smoothing:"));
+    spectrumSmoothingBox = new QDoubleSpinBox;
+    spectrumSmoothingBox->setRange(0, 0.99);
+    spectrumSmoothingBox->setSingleStep(0.05);
+    spectrumSmoothingBox->setValue(settings->value("SpectrumSmoothing", 0.8).toDouble());
+
+    connect(spectrumSizeBox, SIGNAL(currentIndexChanged(int)), this, SLOT(spectrumSizeSlot(int)));
+    connect(spectrumSmoothingBox, SIGNAL(valueChanged(double)), this, SLOT(spectrumSmoothingSlot(double)));
+
+    spectrumLayout = new QVBoxLayout;
+    spectrumLayout->addWidget(spectrumSizeLabel);
+    spectrumLayout->addWidget(spectrumSizeBox);
+    spectrumLayout->addWidget(spectrumSmoothingLabel);
+    spectrumLayout->addWidget(spectrumSmoothingBox);
+    spectrum->setLayout(spectrumLayout);
+
+    timeline = new QGroupBox(tr("Time"));
+
+    timeStepLabel = new QLabel(tr("Advance per frame:"));
+    timeStepBox = new QSpinBox;
+    timeStepBox->setRange(0, 240);
+    timeStepBox->setPrefix(tr("1/"));
+    timeStepBox->setSuffix(tr(" s"));
+    timeStepBox->setSpecialValueText(tr("Real time"));
+    timeStepBox->setValue(settings->value("FixedTimeStep", 0).toInt());
+
+    timelineSpeedLabel = new QLabel(tr("Speed:"));
+    timelineSpeedBox = new QDoubleSpinBox;
+    timelineSpeedBox->setRange(0.1, 8);
+    timelineSpeedBox->setSingleStep(0.1);
+    timelineSpeedBox->setSuffix(tr("x"));
+    timelineSpeedBox->setValue(settings->value("TimelineSpeed", 1.0).toDouble());
+
+    connect(timeStepBox, SIGNAL(valueChanged(int)), this, SLOT(timeStepSlot(int)));
+    connect(timelineSpeedBox, SIGNAL(valueChanged(double)), this, SLOT(timelineSpeedSlot(double)));
+
+    timelineLayout = new QVBoxLayout;
+    timelineLayout->addWidget(timeStepLabel);
+    timelineLayout->addWidget(timeStepBox);
+    timelineLayout->addWidget(timelineSpeedLabel);
+    timelineLayout->addWidget(timelineSpeedBox);
+    timeline->setLayout(timelineLayout);
+
+    recording = new QGroupBox(tr("Recording"));
+
+    recordingTargetLabel = new QLabel(tr("Record to (R in the render window):"));
+    recordingTargetEdit = new QLineEdit;
+    recordingTargetEdit->setPlaceholderText(tr("video.y4m, frames.raw or a named pipe"));
+    recordingTargetEdit->setText(settings->value("RecordingTarget", "").toString());
+
+    connect(recordingTargetEdit, SIGNAL(textChanged(QString)), this, SLOT(recordingTargetSlot(QString)));
+
+    recordingLayout = new QVBoxLayout;
+    recordingLayout->addWidget(recordingTargetLabel);
+    recordingLayout->addWidget(recordingTargetEdit);
+    recording->setLayout(recordingLayout);
+
+    mainLayout = new QVBoxLayout;
+    mainLayout->addWidget(frameRate);
+    mainLayout->addWidget(resolution);
+    mainLayout->addWidget(progressive);
+    mainLayout->addWidget(watchdog);
+    mainLayout->addWidget(spectrum);
+    mainLayout->addWidget(timeline);
+    mainLayout->addWidget(recording);
+    mainLayout->addStretch(1);
+    setLayout(mainLayout);
+}
+
+/**
+ * @brief RenderTab::frameRateSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * frameRateBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::frameRateSlot(int value){
+    settings->insert("FrameRateCap", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::resolutionSlot
+ * @param index
+ *
+ * SLOT that reacts to the currentIndexChanged() SIGNAL of
+ * resolutionBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::resolutionSlot(int index){
+    settings->insert("ResolutionScale", resolutionBox->itemData(index));
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::progressiveSlot
+ * @param index
+ *
+ * SLOT that reacts to the currentIndexChanged() SIGNAL of
+ * progressiveBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::progressiveSlot(int index){
+    settings->insert("ProgressiveTiles", progressiveBox->itemData(index));
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::accumulateSlot
+ * @param state
+ *
+ * SLOT that reacts to the stateChanged() SIGNAL of
+ * accumulateBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::accumulateSlot(int state){
+    settings->insert("Accumulate", state == Qt::Checked);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::watchdogBudgetSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * watchdogBudgetBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::watchdogBudgetSlot(int value){
+    settings->insert("WatchdogBudget", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::watchdogFramesSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * watchdogFramesBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::watchdogFramesSlot(int value){
+    settings->insert("WatchdogFrames", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::spectrumSizeSlot
+ * @param index
+ *
+ * SLOT that reacts to the currentIndexChanged() SIGNAL of
+ * spectrumSizeBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::spectrumSizeSlot(int index){
+    settings->insert("SpectrumSize", spectrumSizeBox->itemData(index));
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::spectrumSmoothingSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * spectrumSmoothingBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::spectrumSmoothingSlot(double value){
+    settings->insert("SpectrumSmoothing", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::timeStepSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * timeStepBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::timeStepSlot(int value){
+    settings->insert("FixedTimeStep", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::timelineSpeedSlot
+ * @param value
+ *
+ * SLOT that reacts to the valueChanged() SIGNAL of
+ * timelineSpeedBox. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::timelineSpeedSlot(double value){
+    settings->insert("TimelineSpeed", value);
+    Q_EMIT contentChanged();
+}
+
+/**
+ * @brief RenderTab::recordingTargetSlot
+ * @param value
+ *
+ * SLOT that reacts to the textChanged() SIGNAL of
+ * recordingTargetEdit. Writes change to Hashlist and Q_EMITs
+ * a contentChanged signal.
+ */
+void RenderTab::recordingTargetSlot(const QString &value){
+    settings->insert("RecordingTarget", value);
+    Q_EMIT contentChanged();
+}
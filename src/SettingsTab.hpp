@@ -11,6 +11,9 @@
 #include <QButtonGroup>
 #include <QMessageBox>
 #include <QStyleFactory>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
+#include <QLineEdit>
 
 /**
  * @brief The SettingsTab class
@@ -103,4 +106,69 @@ private:
     QVBoxLayout* mainLayout;
 };
 
+/**
+ * @brief The RenderTab class
+ *
+ * A subclass of SettingsTab that implements one of the tabs
+ * of the SettingsWindow in which all configurations regarding
+ * the GLSL renderer can be found.
+ */
+class RenderTab : public SettingsTab{
+Q_OBJECT
+public:
+    RenderTab(QHash<QString, QVariant> *Settings, QWidget* parent = 0);
+    ~RenderTab();
+private Q_SLOTS:
+    void frameRateSlot(int);
+    void resolutionSlot(int);
+    void spectrumSizeSlot(int);
+    void spectrumSmoothingSlot(double);
+    void timeStepSlot(int);
+    void timelineSpeedSlot(double);
+    void recordingTargetSlot(const QString &);
+    void progressiveSlot(int);
+    void accumulateSlot(int);
+    void watchdogBudgetSlot(int);
+    void watchdogFramesSlot(int);
+private:
+    void addLayout();
+
+    QGroupBox* frameRate;
+    QLabel* frameRateLabel;
+    QSpinBox* frameRateBox;
+    QHBoxLayout* frameRateLayout;
+    QGroupBox* resolution;
+    QLabel* resolutionLabel;
+    QComboBox* resolutionBox;
+    QHBoxLayout* resolutionLayout;
+    QGroupBox* progressive;
+    QLabel* progressiveLabel;
+    QComboBox* progressiveBox;
+    QCheckBox* accumulateBox;
+    QVBoxLayout* progressiveLayout;
+    QGroupBox* watchdog;
+    QLabel* watchdogBudgetLabel;
+    QSpinBox* watchdogBudgetBox;
+    QLabel* watchdogFramesLabel;
+    QSpinBox* watchdogFramesBox;
+    QVBoxLayout* watchdogLayout;
+    QGroupBox* spectrum;
+    QLabel* spectrumSizeLabel;
+    QComboBox* spectrumSizeBox;
+    QLabel* spectrumSmoothingLabel;
+    QDoubleSpinBox* spectrumSmoothingBox;
+    QVBoxLayout* spectrumLayout;
+    QGroupBox* timeline;
+    QLabel* timeStepLabel;
+    QSpinBox* timeStepBox;
+    QLabel* timelineSpeedLabel;
+    QDoubleSpinBox* timelineSpeedBox;
+    QVBoxLayout* timelineLayout;
+    QGroupBox* recording;
+    QLabel* recordingTargetLabel;
+    QLineEdit* recordingTargetEdit;
+    QVBoxLayout* recordingLayout;
+    QVBoxLayout* mainLayout;
+};
+
 #endif // SETTINGTABS
@@ -13,11 +13,14 @@ SettingsWindow::SettingsWindow(int subDirNum){
     tabs = new QTabWidget;
     layout = new LayoutTab(&settingsDict, this);
     behaviour = new BehaviourTab(&settingsDict, this);
+    render = new RenderTab(&settingsDict, this);
     changed = false;
     tabs->addTab(layout, "Layout");
     connect(layout, SIGNAL(contentChanged()), this, SLOT(changedTrue()));
     tabs->addTab(behaviour, "Behaviour");
     connect(behaviour, SIGNAL(contentChanged()), this, SLOT(changedTrue()));
+    tabs->addTab(render, "Rendering");
+    connect(render, SIGNAL(contentChanged()), this, SLOT(changedTrue()));
 
     auto* horizontal = new QHBoxLayout();
     horizontal->addWidget(tabs, 1);
@@ -54,6 +57,7 @@ SettingsWindow::SettingsWindow(int subDirNum){
 SettingsWindow::~SettingsWindow(){
     delete layout;
     delete behaviour;
+    delete render;
     delete tabs;
 }
 
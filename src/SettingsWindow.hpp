@@ -34,6 +34,7 @@ private:
     QTabWidget *tabs;
     LayoutTab *layout;
     BehaviourTab *behaviour;
+    RenderTab *render;
     QHash<QString,QVariant> settingsDict;
     int subDir;
 };
@@ -0,0 +1,829 @@
+#include "ShaderCompiler.hpp"
+#include "Renderer.hpp"
+
+const char * ShaderCompiler::defaultVertexShader =
+        "#version 330 core\n"
+        "\n"
+        "in vec3 position;\n"
+        "in vec2 texCoord;\n"
+        "\n"
+        "out vec2  uv;\n"
+        "\n"
+        "void main(){\n"
+        "   gl_Position = vec4(position, 1);\n"
+        "   uv = texCoord;\n"
+        "}";
+
+const char * ShaderCompiler::defaultFragmentShader =
+        "#version 330 core\n"
+        "\n"
+        "out vec4 color;\n"
+        "\n"
+        "in vec2 uv;\n"
+        "uniform float time;\n"
+        "uniform vec2 mouse;\n"
+        "uniform float ration;\n"
+        "\n"
+        "void main(){\n"
+        "     color = vec4(cos(uv.x * 5 - time / 1000) / 2 + .5, 0, sin(uv.x * 5 - time / 1000) / 2 + .5, 1);\n"
+        "}";
+
+const char * ShaderCompiler::builtinBlockName = "VeToBuiltins";
+
+const int ShaderCompiler::cacheSize = 32;
+
+const int ShaderCompiler::maximumVertexCount = 1 << 26;
+
+const int ShaderCompiler::maximumStorageBuffers = 8;
+
+const int ShaderCompiler::maximumComputeGroups = 65535;
+
+/**
+ * The primitive types a #vertex directive accepts
+ */
+static const struct{ const char *name; GLenum mode; } vertexPrimitives[] = {
+    {"points", GL_POINTS},
+    {"lines", GL_LINES},
+    {"line_strip", GL_LINE_STRIP},
+    {"line_loop", GL_LINE_LOOP},
+    {"triangles", GL_TRIANGLES},
+    {"triangle_strip", GL_TRIANGLE_STRIP},
+    {"triangle_fan", GL_TRIANGLE_FAN}
+};
+
+/**
+ * The members of the VeToBuiltins uniform block in declaration order;
+ * must match the BuiltinUniforms struct of the Renderer.
+ */
+static const char *builtinUniforms[][2] = {
+    {"vec2", "resolution"},
+    {"vec2", "mouse"},
+    {"float", "time"},
+    {"float", "deltaTime"},
+    {"float", "timeSeconds"},
+    {"float", "timeFraction"},
+    {"float", "ration"},
+    {"float", "aspect"},
+    {"int", "frame"},
+    {"int", "audioHistoryRow"}
+};
+
+/**
+ * @brief programKey
+ * @param pass Preprocessed pass
+ * @return The source a linked program of pass is cached by
+ */
+static QString programKey(const ShaderPass &pass){
+    const QString stage = pass.computeGroups[0] > 0 ? "#compute\n" : "";
+    return stage + pass.vertexSource + pass.source;
+}
+
+/**
+ * @brief ShaderCompiler::ShaderCompiler
+ * @param parent Parent object of the compiler
+ *
+ * Create a new compiler. Must be called on the GUI thread,
+ * since the offscreen surface is created here.
+ */
+ShaderCompiler::ShaderCompiler(QObject *parent) :
+    QObject(parent),
+    context(0),
+    hasPendingCode(false),
+    vertexShader(0),
+    binaries(0),
+    programs(cacheSize)
+{
+    surface = new QOffscreenSurface();
+    surface->setFormat(Renderer::surfaceFormat());
+    surface->create();
+}
+
+/**
+ * @brief ShaderCompiler::~ShaderCompiler
+ *
+ * Free resources. The thread of the compiler must be
+ * finished, release() has freed the graphic resources.
+ */
+ShaderCompiler::~ShaderCompiler(){
+    delete context;
+    delete surface;
+}
+
+/**
+ * @brief ShaderCompiler::createContext
+ * @param shareContext Context of the renderer the programs are compiled for
+ * @return True on success, otherwise false
+ *
+ * Create the compiler context sharing with shareContext and
+ * hand it over to the thread of the compiler. Must be called
+ * on the thread of shareContext before it is made current.
+ */
+bool ShaderCompiler::createContext(QOpenGLContext *shareContext){
+    QOpenGLContext *newContext = new QOpenGLContext();
+    newContext->setFormat(shareContext->format());
+    newContext->setShareContext(shareContext);
+    if(!newContext->create() || !QOpenGLContext::areSharing(newContext, shareContext)){
+        delete newContext;
+        return false;
+    }
+    newContext->moveToThread(thread());
+
+    mutex.lock();
+    context = newContext;
+    mutex.unlock();
+
+    QMetaObject::invokeMethod(this, "compilePending", Qt::QueuedConnection);
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::queueCode
+ * @param filename Name of the shader file
+ * @param code Shader code to compile
+ *
+ * Enqueue code for compilation; replaces code that has
+ * not been compiled yet. Thread-safe.
+ */
+void ShaderCompiler::queueCode(const QString &filename, const QString &code){
+    QMutexLocker locker(&mutex);
+    pendingCode = QPair<QString, QString>(filename, code);
+    if(!hasPendingCode){
+        hasPendingCode = true;
+        QMetaObject::invokeMethod(this, "compilePending", Qt::QueuedConnection);
+    }
+}
+
+/**
+ * @brief ShaderCompiler::takeResults
+ * @return Compiled shaders in the order they were finished
+ *
+ * The caller takes ownership of the results. Thread-safe.
+ */
+QList<CompiledShader*> ShaderCompiler::takeResults(){
+    QList<CompiledShader*> finished;
+    QMutexLocker locker(&mutex);
+    finished.swap(results);
+    return finished;
+}
+
+/**
+ * @brief ShaderCompiler::forgetLastCode
+ *
+ * Compile the next queued code even if it equals the last
+ * successful compilation, because the renderer no longer shows
+ * that program as it was compiled. Thread-safe.
+ */
+void ShaderCompiler::forgetLastCode(){
+    QMutexLocker locker(&mutex);
+    lastKey.clear();
+}
+
+/**
+ * @brief ShaderCompiler::compilePending
+ *
+ * Compile the newest queued code with the compiler context
+ * and Q_EMIT compiled once the result is ready for other contexts.
+ * Linked programs are kept in a least recently used cache, keyed by
+ * the expanded source of each pass, and their binaries on disk for
+ * the next run; cached passes are not compiled again. Texture images
+ * are decoded on the global thread pool while the programs link.
+ * Code that equals the last successful compilation is ignored.
+ */
+void ShaderCompiler::compilePending(){
+    mutex.lock();
+    if(!context || !hasPendingCode){
+        mutex.unlock();
+        return;
+    }
+    QPair<QString, QString> code = pendingCode;
+    hasPendingCode = false;
+    mutex.unlock();
+
+    if(!context->makeCurrent(surface)){
+        qWarning() << tr("Failed to activate the shader compiler context.");
+        return;
+    }
+
+    ImageList images;
+    CompiledShader *result = preprocess(code.first, code.second, images);
+    if(result->error.isEmpty()){
+        mutex.lock();
+        const bool unchanged = result->key == lastKey;
+        mutex.unlock();
+        if(unchanged){
+            delete result;
+            context->doneCurrent();
+            return;
+        }
+
+        // the images are decoded on the thread pool while the program is linked
+        QStringList decodedPaths;
+        QFuture<QImage> decoding = decodeTextures(images, decodedPaths);
+
+        for(ShaderPass &pass : result->passes){
+            const QString programSource = programKey(pass);
+            QByteArray passKey = QCryptographicHash::hash(programSource.toUtf8(), QCryptographicHash::Sha1);
+            QSharedPointer<QOpenGLShaderProgram> *cached = programs.object(passKey);
+            if(cached){
+                pass.program = *cached;
+                continue;
+            }
+            if(!binaries)
+                binaries = new ProgramBinaryCache(context);
+            pass.program = QSharedPointer<QOpenGLShaderProgram>(binaries->load(programSource));
+            if(!pass.program){
+                if(!vertexShader){
+                    vertexShader = new QOpenGLShader(QOpenGLShader::Vertex, this);
+                    if(!vertexShader->compileSourceCode(defaultVertexShader))
+                        qWarning() << tr("Failed to compile default vertex shader.");
+                }
+                if(!link(result, pass, vertexShader, binaries))
+                    break;
+            }
+            programs.insert(passKey, new QSharedPointer<QOpenGLShaderProgram>(pass.program));
+        }
+        if(result->error.isEmpty())
+            result->program = result->passes.last().program;
+
+        if(result->program && loadTextures(result, images, decodedPaths, decoding)){
+            mutex.lock();
+            lastKey = result->key;
+            mutex.unlock();
+        }else
+            decoding.cancel();
+    }
+    // the objects have to be complete before another context uses them
+    context->functions()->glFinish();
+    context->doneCurrent();
+
+    mutex.lock();
+    results.enqueue(result);
+    mutex.unlock();
+
+    Q_EMIT compiled();
+}
+
+/**
+ * @brief ShaderCompiler::release
+ *
+ * Free the cache, the results nobody took and the compiler
+ * context. Must be called on the thread of the compiler.
+ */
+void ShaderCompiler::release(){
+    QMutexLocker locker(&mutex);
+    if(!context)
+        return;
+    context->makeCurrent(surface);
+    qDeleteAll(results);
+    results.clear();
+    programs.clear();
+    delete vertexShader;
+    vertexShader = 0;
+    delete binaries;
+    binaries = 0;
+    lastKey.clear();
+    context->doneCurrent();
+    delete context;
+    context = 0;
+}
+
+/**
+ * @brief ShaderCompiler::compile
+ * @param filename Name of the shader file; used to find texture images
+ * @param code Fragment shader code
+ * @return The compiled shader; owned by the caller
+ *
+ * Expand the directives, compile and link the programs of all
+ * passes and load the textures with the current context, bypassing
+ * the cache.
+ */
+CompiledShader *ShaderCompiler::compile(const QString &filename, const QString &code){
+    ImageList images;
+    CompiledShader *result = preprocess(filename, code, images);
+    if(!result->error.isEmpty())
+        return result;
+    QStringList decodedPaths;
+    QFuture<QImage> decoding = decodeTextures(images, decodedPaths);
+    for(ShaderPass &pass : result->passes)
+        if(!link(result, pass, 0, 0))
+            break;
+    if(result->error.isEmpty())
+        result->program = result->passes.last().program;
+    if(result->program)
+        loadTextures(result, images, decodedPaths, decoding);
+    else
+        decoding.cancel();
+    return result;
+}
+
+/**
+ * @brief ShaderCompiler::preprocess
+ * @param filename Name of the shader file; used to find texture images
+ * @param code Fragment shader code
+ * @param images Receives the uniform names and paths of the texture images
+ * @return A shader with the expanded source, its passes and its cache
+ * key, or with an error if an image does not exist or a pass is invalid
+ *
+ * Hoist the float literals, replace the texture and buffer
+ * directives by declarations, collect the annotated uniforms, split
+ * the source into its passes, split off the compute and vertex stages
+ * and declare the built-in uniforms and the literals of each pass.
+ * The programs only depend on the hoisted code, so edits of literals
+ * find them in the cache.
+ */
+CompiledShader *ShaderCompiler::preprocess(const QString &filename, const QString &code, ImageList &images){
+    QRegExp textureRegEx("(^|\n|\r)\\s*#texture\\s+([A-Za-z_][A-Za-z0-9_]*)\\s+([^\n\r]+)");
+    QFileInfo codeFile(filename);
+
+    CompiledShader *result = new CompiledShader();
+    result->file = filename;
+    result->code = code;
+    QString fragmentShader = ShaderLiterals::hoist(code, result->literals);
+    result->skeleton = fragmentShader;
+
+    int pos = 0;
+    while((pos = textureRegEx.indexIn(fragmentShader, pos)) != -1){
+        QString imageName = textureRegEx.cap(2).trimmed();
+        QString imagePath = textureRegEx.cap(3).trimmed();
+        QFileInfo textureImage;
+
+        if(codeFile.exists())
+            textureImage = QFileInfo(codeFile.dir(), imagePath);
+        else
+            textureImage = QFileInfo(imagePath);
+
+        if(!textureImage.isFile()){
+            qDebug() << "Texture image does not exsit: " << imagePath;
+            if(code == defaultFragmentShader)
+                qWarning() << tr("Failed to compile default shader.");
+            result->error = "Image file does not exist: " + imagePath;
+            result->errorLine = fragmentShader.mid(0, pos).count('\n');
+            return result;
+        }
+
+        images.append(QPair<QString, QString>(imageName, textureImage.absoluteFilePath()));
+
+        QString textureDefinition(textureRegEx.cap(1) + "uniform sampler2D " + imageName + ";");
+        fragmentShader.remove(pos, textureRegEx.matchedLength());
+        fragmentShader.insert(pos, textureDefinition);
+        pos += textureDefinition.length();
+    }
+
+    if(!declareStorageBuffers(result, fragmentShader))
+        return result;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fragmentShader.toUtf8());
+    for(const QPair<QString, QString> &image : images){
+        hash.addData(image.second.toUtf8());
+        hash.addData(QByteArray::number(QFileInfo(image.second).lastModified().toMSecsSinceEpoch()));
+    }
+    hash.addData(reinterpret_cast<const char*>(result->literals.constData()), result->literals.size() * int(sizeof(float)));
+
+    result->key = hash.result();
+    result->source = fragmentShader;
+    // the renderer sets the built-ins itself
+    for(const ShaderParameter &parameter : ShaderParameter::parse(fragmentShader)){
+        bool builtin = false;
+        for(const auto &uniform : builtinUniforms)
+            builtin = builtin || parameter.name == uniform[1];
+        if(!builtin)
+            result->parameters.append(parameter);
+    }
+    if(!splitPasses(result))
+        return result;
+    for(ShaderPass &pass : result->passes){
+        if(!splitComputeStage(result, pass) || !splitVertexStage(result, pass))
+            return result;
+        declareBuiltins(pass.source);
+        ShaderLiterals::declare(pass.source, result->literals.size());
+        if(pass.vertexCount > 0){
+            declareBuiltins(pass.vertexSource);
+            ShaderLiterals::declare(pass.vertexSource, result->literals.size());
+        }
+    }
+    if(result->passes.last().computeGroups[0] > 0){
+        result->error = "The last pass draws the image and can not be a #compute pass";
+        const int last = result->source.lastIndexOf(QRegExp("(^|\n|\r)[ \t]*#pass\\b"));
+        result->errorLine = result->source.left(last + 1).count('\n');
+    }
+    return result;
+}
+
+/**
+ * @brief ShaderCompiler::declareStorageBuffers
+ * @param result Shader that receives the buffers or the error
+ * @param source Source that receives the declarations
+ * @return True on success, otherwise false and the error is set
+ *
+ * Replace each line "#buffer NAME COUNT TYPE" by the declaration of
+ * a std430 storage block with the array TYPE NAME[] and the next free
+ * binding point. TYPE may be a struct declared before. The renderer
+ * allocates COUNT elements, zeroed, and keeps them while a shader
+ * declares the buffer with the same name and size.
+ */
+bool ShaderCompiler::declareStorageBuffers(CompiledShader *result, QString &source){
+    QRegExp bufferRegEx("(^|\n|\r)[ \t]*#buffer\\b([^\n\r]*)");
+    QRegExp argumentsRegEx("\\s*([A-Za-z_][A-Za-z0-9_]*)\\s+([0-9]+)\\s+([A-Za-z_][A-Za-z0-9_]*)\\s*");
+    int pos = 0;
+    while((pos = bufferRegEx.indexIn(source, pos)) != -1){
+        const int start = pos + bufferRegEx.cap(1).length();
+        bool valid = argumentsRegEx.exactMatch(bufferRegEx.cap(2));
+        const QString name = argumentsRegEx.cap(1);
+        const int count = valid ? argumentsRegEx.cap(2).toInt(&valid) : 0;
+        for(const QPair<QString, int> &buffer : result->storageBuffers)
+            valid = valid && buffer.first != name;
+        if(!valid || count <= 0 || count > maximumVertexCount
+                || result->storageBuffers.length() == maximumStorageBuffers){
+            result->error = QString("Invalid #buffer directive; expected \"#buffer NAME COUNT TYPE\" with a new "
+                                    "name, at most %1 elements and at most %2 buffers")
+                    .arg(maximumVertexCount).arg(maximumStorageBuffers);
+            result->errorLine = source.left(start).count('\n');
+            return false;
+        }
+
+        const QString declaration = QString("layout(std430, binding = %1) buffer %2Buffer{ %3 %2[]; };")
+                .arg(result->storageBuffers.length()).arg(name, argumentsRegEx.cap(3));
+        result->storageBuffers.append(QPair<QString, int>(name, count));
+        source.replace(start, pos + bufferRegEx.matchedLength() - start, declaration);
+        pos = start + declaration.length();
+    }
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::splitPasses
+ * @param result Shader with the expanded source; receives the passes
+ * @return True on success, otherwise false and the error is set
+ *
+ * Split the source at its #pass directives. The code before the
+ * first directive is shared by all passes, each directive starts
+ * the code of a pass with the given name, which must be a new
+ * identifier other than backbuffer. Every pass may read the
+ * buffers of all passes by name and its own last frame as backbuffer;
+ * the samplers are declared in place of the directive. Code of the
+ * other passes is replaced by empty lines, so error lines stay valid.
+ * Without directives the whole source is the only pass.
+ */
+bool ShaderCompiler::splitPasses(CompiledShader *result){
+    QRegExp passRegEx("(^|\n|\r)[ \t]*#pass\\b([^\n\r]*)");
+    QRegExp nameRegEx("[ \t]*([A-Za-z_][A-Za-z0-9_]*)([ \t].*)?");
+    const QString &source = result->source;
+    QStringList names;
+    QList<int> starts, bodies;
+
+    int pos = 0;
+    while((pos = passRegEx.indexIn(source, pos)) != -1){
+        int start = pos + passRegEx.cap(1).length();
+        const bool valid = nameRegEx.exactMatch(passRegEx.cap(2));
+        QString name = valid ? nameRegEx.cap(1) : passRegEx.cap(2).trimmed();
+        if(!valid || name == "backbuffer" || names.contains(name)){
+            result->error = name.isEmpty() ? QString("Missing pass name") : "Invalid pass name: " + name;
+            result->errorLine = source.left(start).count('\n');
+            return false;
+        }
+        names.append(name);
+        starts.append(start);
+        bodies.append(pos + passRegEx.matchedLength());
+        pos += passRegEx.matchedLength();
+    }
+
+    if(names.isEmpty()){
+        ShaderPass pass;
+        pass.source = source;
+        result->passes.append(pass);
+        return true;
+    }
+
+    QString declarations;
+    for(const QString &name : names)
+        declarations += "uniform sampler2D " + name + "; ";
+    declarations += "uniform sampler2D backbuffer;";
+
+    const QString common = source.left(starts.first());
+    QString padding;
+    for(int i = 0; i < names.length(); ++i){
+        int end = i + 1 < names.length() ? starts[i + 1] : source.length();
+        ShaderPass pass;
+        pass.name = names[i];
+        pass.source = common + padding + declarations + source.mid(bodies[i], end - bodies[i]);
+        result->passes.append(pass);
+        padding += QString(source.mid(starts[i], end - starts[i]).count('\n'), '\n');
+    }
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::splitComputeStage
+ * @param result Shader of the pass; receives the error
+ * @param pass Pass to split; receives the work group counts
+ * @return True on success, otherwise false and the error is set
+ *
+ * A line "#compute X [Y [Z]]" makes the pass a compute shader
+ * that is dispatched with X by Y by Z work groups every frame,
+ * in the order of the passes. The shader declares its local size
+ * itself. It writes storage buffers, so the shared code must
+ * not declare inputs or outputs. The directive is removed.
+ */
+bool ShaderCompiler::splitComputeStage(CompiledShader *result, ShaderPass &pass){
+    QRegExp computeRegEx("(^|\n|\r)[ \t]*#compute\\b([^\n\r]*)");
+    const QString &source = pass.source;
+    int pos = computeRegEx.indexIn(source);
+    if(pos == -1)
+        return true;
+
+    const int start = pos + computeRegEx.cap(1).length();
+    const int body = pos + computeRegEx.matchedLength();
+    const QStringList arguments = computeRegEx.cap(2).split(QRegExp("\\s+"), QString::SkipEmptyParts);
+
+    bool valid = !arguments.isEmpty() && arguments.length() <= 3 && !pass.name.isEmpty();
+    for(int i = 0; i < 3; ++i){
+        bool number = true;
+        pass.computeGroups[i] = i < arguments.length() ? arguments[i].toInt(&number) : 1;
+        valid = valid && number && pass.computeGroups[i] > 0 && pass.computeGroups[i] <= maximumComputeGroups;
+    }
+    if(!valid || computeRegEx.indexIn(source, body) != -1 || source.contains(QRegExp("(^|\n|\r)[ \t]*#vertex\\b"))){
+        result->error = QString("Invalid #compute directive; expected \"#compute X [Y [Z]]\" once in a #pass "
+                                "without #vertex, with at most %1 work groups each").arg(maximumComputeGroups);
+        result->errorLine = source.left(start).count('\n');
+        pass.computeGroups[0] = 0;
+        return false;
+    }
+
+    pass.source = source.left(start) + source.mid(body);
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::splitVertexStage
+ * @param result Shader of the pass; receives the error
+ * @param pass Pass to split; receives the vertex stage
+ * @return True on success, otherwise false and the error is set
+ *
+ * A line "#vertex COUNT [PRIMITIVE] [BLENDING]" makes the code
+ * behind it the vertex shader of the pass, up to an optional
+ * "#fragment" line that starts its fragment shader. The code in
+ * front of the directive is shared by both. The vertex shader
+ * is run COUNT times without vertex buffers; it positions the
+ * vertices from gl_VertexID and the constant vertexCount and
+ * may set gl_PointSize and vertexColor. Without a fragment
+ * section the primitives are filled with vertexColor. PRIMITIVE
+ * is one of the names in vertexPrimitives, points by default, and
+ * BLENDING one of opaque, additive and alpha, opaque by default.
+ * As in splitPasses, code of the other stage is replaced by
+ * empty lines.
+ */
+bool ShaderCompiler::splitVertexStage(CompiledShader *result, ShaderPass &pass){
+    QRegExp vertexRegEx("(^|\n|\r)[ \t]*#vertex\\b([^\n\r]*)");
+    QRegExp fragmentRegEx("(^|\n|\r)[ \t]*#fragment\\b[^\n\r]*");
+    const QString &source = pass.source;
+    int pos = vertexRegEx.indexIn(source);
+    if(pos == -1)
+        return true;
+
+    const int start = pos + vertexRegEx.cap(1).length();
+    const int body = pos + vertexRegEx.matchedLength();
+    const QStringList arguments = vertexRegEx.cap(2).split(QRegExp("\\s+"), QString::SkipEmptyParts);
+    const QString prefix = pass.name.isEmpty() ? QString() : "Pass " + pass.name + ": ";
+
+    bool valid = !arguments.isEmpty() && arguments.length() <= 3;
+    int count = valid ? arguments[0].toInt(&valid) : 0;
+    valid = valid && count > 0 && count <= maximumVertexCount;
+    for(int i = 1; valid && i < arguments.length(); ++i){
+        const QString &argument = arguments[i];
+        bool known = false;
+        for(const auto &primitive : vertexPrimitives)
+            if(argument == primitive.name){
+                pass.primitive = primitive.mode;
+                known = true;
+            }
+        if(argument == "opaque" || argument == "additive" || argument == "alpha"){
+            pass.blending = argument == "opaque" ? ShaderPass::Opaque :
+                            argument == "additive" ? ShaderPass::Additive : ShaderPass::AlphaBlending;
+            known = true;
+        }
+        valid = known;
+    }
+    if(!valid || vertexRegEx.indexIn(source, body) != -1){
+        result->error = prefix + QString("Invalid #vertex directive; expected \"#vertex COUNT [PRIMITIVE] [BLENDING]\" "
+                                         "once per pass with at most %1 vertices").arg(maximumVertexCount);
+        result->errorLine = source.left(start).count('\n');
+        return false;
+    }
+
+    int end = fragmentRegEx.indexIn(source, body);
+    const bool fragmentSection = end != -1;
+    int fragmentBody = source.length();
+    if(fragmentSection){
+        fragmentBody = end + fragmentRegEx.matchedLength();
+        end += fragmentRegEx.cap(1).length();
+    }else{
+        end = source.length();
+    }
+
+    QString fragment = "in vec4 vertexColor;";
+    if(!fragmentSection){
+        // fill the primitives; the location keeps outputs of the shared code from taking it
+        QRegExp versionRegEx("^\\s*#version\\s+(\\d+)");
+        const bool locations = versionRegEx.indexIn(source) != -1 && versionRegEx.cap(1).toInt() >= 330;
+        fragment += QString(" %1out vec4 vertexFragmentColor; void main(){ vertexFragmentColor = vertexColor; }")
+                .arg(locations ? "layout(location = 0) " : "");
+    }
+
+    const QString common = source.left(start);
+    const QString padding(source.mid(start, end - start).count('\n'), '\n');
+    pass.vertexCount = count;
+    pass.vertexSource = common + QString("out vec4 vertexColor; const int vertexCount = %1;").arg(count) +
+            source.mid(body, end - body);
+    pass.source = common + padding + fragment + source.mid(fragmentBody);
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::declareBuiltins
+ * @param source Source of a pass; receives the uniform block
+ * @return True if the built-in uniforms are declared as uniform block
+ *
+ * Declare the built-in uniforms of the renderer as one std140
+ * uniform block, so that the renderer updates all of them with
+ * a single buffer upload per frame. Declarations of built-ins
+ * with the built-in type are replaced by the block, others need
+ * no declaration at all. The block is put in place of the first
+ * replaced declaration or in front of the first line after the
+ * leading directives, so error lines stay valid. The source stays
+ * as it is if it is older than GLSL 1.40 or might declare one of
+ * the names otherwise; the renderer sets the plain uniforms then.
+ */
+bool ShaderCompiler::declareBuiltins(QString &source){
+    QRegExp versionRegEx("^\\s*#version\\s+(\\d+)");
+    if(versionRegEx.indexIn(source) == -1 || versionRegEx.cap(1).toInt() < 140)
+        return false;
+
+    // blank the matching declarations, keeping all positions
+    QString declared = source;
+    int first = -1;
+    for(const auto &builtin : builtinUniforms){
+        QRegExp declarationRegEx(QString("\\buniform\\s+%1\\s+%2\\s*;").arg(builtin[0], builtin[1]));
+        int pos = 0;
+        while((pos = declarationRegEx.indexIn(declared, pos)) != -1){
+            declared.replace(pos, declarationRegEx.matchedLength(), QString(declarationRegEx.matchedLength(), ' '));
+            int lineStart = declared.lastIndexOf('\n', pos) + 1;
+            bool commented = declared.mid(lineStart, pos - lineStart).contains("//");
+            if(!commented && (first < 0 || pos < first))
+                first = pos;
+        }
+    }
+
+    for(const auto &builtin : builtinUniforms){
+        QRegExp conflictRegEx(QString("(^|[^A-Za-z0-9_.])(?!return\\b|else\\b)[A-Za-z_][A-Za-z0-9_]*\\s+%1\\s*[;=,\\[(]")
+                              .arg(builtin[1]));
+        if(conflictRegEx.indexIn(declared) != -1)
+            return false;
+    }
+
+    QString block = QString("layout(std140) uniform %1{").arg(builtinBlockName);
+    for(const auto &builtin : builtinUniforms)
+        block += QString(" %1 %2;").arg(builtin[0], builtin[1]);
+    block += " };";
+
+    if(first < 0){
+        // behind #version and everything else that has to come first
+        QStringList lines = declared.split('\n');
+        int line = 0;
+        while(line < lines.length() && lines[line].trimmed().startsWith('#'))
+            ++line;
+        first = 0;
+        for(int i = 0; i < line; ++i)
+            first += lines[i].length() + 1;
+        if(first > declared.length())
+            return false;
+        block += ' ';
+    }
+    source = declared.insert(first, block);
+    return true;
+}
+
+/**
+ * @brief ShaderCompiler::link
+ * @param result Preprocessed shader; receives the error
+ * @param pass Pass of result; receives the program
+ * @param vertex Compiled vertex shader or 0 to compile the default one
+ * @param binaries Disk cache that receives the linked program or 0
+ * @return True on success, otherwise false
+ *
+ * Compile and link the program of a pass with the current context.
+ * The attribute locations are fixed, so all passes can share the
+ * vertex array of the renderer. Passes with a vertex stage of their
+ * own use it instead of the vertex shader; compute passes have no
+ * other stage.
+ */
+bool ShaderCompiler::link(CompiledShader *result, ShaderPass &pass, QOpenGLShader *vertex, ProgramBinaryCache *binaries){
+    QOpenGLShaderProgram *program = new QOpenGLShaderProgram();
+    bool hasError = false;
+
+    if(pass.computeGroups[0] > 0){
+        if(!QOpenGLShader::hasOpenGLShaders(QOpenGLShader::Compute)){
+            result->error = "Pass " + pass.name + ": Compute shaders need OpenGL 4.3";
+            delete program;
+            return false;
+        }
+        if(!program->addShaderFromSourceCode(QOpenGLShader::Compute, pass.source))
+            hasError = true;
+    }else if(pass.vertexCount > 0){
+        if(!program->addShaderFromSourceCode(QOpenGLShader::Vertex, pass.vertexSource))
+            hasError = true;
+    }else if(vertex){
+        if(!vertex->isCompiled() || !program->addShader(vertex))
+            hasError = true;
+    }else if(!program->addShaderFromSourceCode(QOpenGLShader::Vertex, defaultVertexShader)){
+        hasError = true;
+        qWarning() << tr("Failed to compile default vertex shader.");
+    }
+    if(!hasError && pass.computeGroups[0] == 0 &&
+            !program->addShaderFromSourceCode(QOpenGLShader::Fragment, pass.source))
+        hasError = true;
+    if(!hasError){
+        program->bindAttributeLocation("position", 0);
+        program->bindAttributeLocation("texCoord", 1);
+        if(binaries)
+            binaries->prepare(program);
+        if(!program->link())
+            hasError = true;
+    }
+
+    if(!hasError){
+        if(binaries)
+            binaries->store(programKey(pass), program);
+        pass.program = QSharedPointer<QOpenGLShaderProgram>(program);
+        return true;
+    }
+
+    result->error = program->log();
+    if(!pass.name.isEmpty())
+        result->error = "Pass " + pass.name + ": " + result->error;
+    delete program;
+
+    if(result->code == defaultFragmentShader)
+        qWarning() << tr("Failed to compile default shader.");
+
+    //mac  :<line>:
+    //mesa :<line>(<errorcode>):
+    QRegExp errorline(":([0-9]+)(\\([0-9]+\\))?:");
+    if(errorline.indexIn(result->error) > -1){
+        int line = errorline.cap(1).toInt();
+        if(line-3 > 0)  // because: "#define lowp", "#define mediump" and "#define highp"
+            result->errorLine = line-3;
+        else
+            result->errorLine = line;
+    }
+    return false;
+}
+
+/**
+ * @brief ShaderCompiler::decodeTextures
+ * @param images Uniform names and paths of the texture images
+ * @param paths Receives the paths of the images that are decoded
+ * @return The decoded images in the order of paths
+ *
+ * Start decoding the images that are not cached yet on the
+ * global thread pool. Needs a current context for the lookup.
+ */
+QFuture<QImage> ShaderCompiler::decodeTextures(const ImageList &images, QStringList &paths){
+    for(const QPair<QString, QString> &image : images)
+        if(!paths.contains(image.second) && !TextureCache::cached(image.second))
+            paths.append(image.second);
+    return QtConcurrent::mapped(paths, TextureCache::decode);
+}
+
+/**
+ * @brief ShaderCompiler::loadTextures
+ * @param result Linked shader; receives the textures
+ * @param images Uniform names and paths of the texture images
+ * @param paths Paths of the images that are decoded
+ * @param decoded The images that are decoded, in the order of paths
+ * @return True on success; otherwise the program of result is dropped
+ *
+ * Fetch the texture images from the TextureCache with the current
+ * context, uploading each image as soon as it is decoded.
+ */
+bool ShaderCompiler::loadTextures(CompiledShader *result, const ImageList &images,
+                                  const QStringList &paths, QFuture<QImage> decoded){
+    for(const QPair<QString, QString> &image : images){
+        QSharedPointer<SharedTexture> texture;
+        int index = paths.indexOf(image.second);
+        if(index >= 0)
+            texture = TextureCache::insert(image.second, decoded.resultAt(index));
+        else
+            texture = TextureCache::texture(image.second);
+
+        if(!texture){
+            decoded.cancel();
+            result->program.clear();
+            result->textures.clear();
+            result->error = "Image file could not be read: " + image.second;
+            return false;
+        }
+        result->textures.append(QPair<QString, QSharedPointer<SharedTexture>>(image.first, texture));
+    }
+    return true;
+}
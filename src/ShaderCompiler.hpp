@@ -0,0 +1,153 @@
+#ifndef SHADERCOMPILER_HPP
+#define SHADERCOMPILER_HPP
+
+#include <QObject>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOffscreenSurface>
+#include <QFileInfo>
+#include <QDir>
+#include <QImage>
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QQueue>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QDebug>
+
+#include "ProgramBinaryCache.hpp"
+#include "TextureCache.hpp"
+#include "ShaderParameter.hpp"
+#include "ShaderLiterals.hpp"
+
+/**
+ * @brief The ShaderPass struct
+ *
+ * One pass of a multi-pass shader: the expanded fragment
+ * source of the pass and its linked program. The name is
+ * empty for shaders without #pass directives. Passes with
+ * a #vertex directive bring their own vertex shader and draw
+ * vertexCount vertices without buffers instead of the quad.
+ * Passes with a #compute directive are compute shaders that are
+ * dispatched with computeGroups work groups and draw nothing.
+ */
+struct ShaderPass{
+    enum Blending{ Opaque, Additive, AlphaBlending };
+
+    ShaderPass() : vertexCount(0), primitive(GL_POINTS), blending(Opaque)
+    {
+        computeGroups[0] = computeGroups[1] = computeGroups[2] = 0;
+    }
+    QString name;
+    QString source;
+    QString vertexSource;
+    int vertexCount;
+    GLenum primitive;
+    Blending blending;
+    int computeGroups[3];
+    QSharedPointer<QOpenGLShaderProgram> program;
+};
+
+/**
+ * @brief The CompiledShader struct
+ *
+ * The outcome of a ShaderCompiler run: either the linked
+ * programs of all passes with the texture images or an error
+ * message. program is the program of the last pass, which
+ * draws the image that is displayed. storageBuffers holds the
+ * name and element count of each #buffer directive; the index
+ * is the binding point of the buffer. parameters are the
+ * uniforms annotated to be set from the editor. code is the code
+ * as it was queued, skeleton the code with its float literals
+ * hoisted into a uniform array and literals their values.
+ * The program may be shared with the cache of the compiler,
+ * the textures with the TextureCache. The GL objects belong
+ * to the share group of the compiler, so a context of that
+ * group must be current on deletion.
+ */
+struct CompiledShader{
+    CompiledShader() : errorLine(-1) { }
+    QByteArray key;
+    QString file;
+    QString code;
+    QString skeleton;
+    QString source;
+    QSharedPointer<QOpenGLShaderProgram> program;
+    QList<ShaderPass> passes;
+    QList<QPair<QString, QSharedPointer<SharedTexture>>> textures;
+    QList<QPair<QString, int>> storageBuffers;
+    QList<ShaderParameter> parameters;
+    QVector<float> literals;
+    QString error;
+    int errorLine;
+};
+
+/**
+ * @brief The ShaderCompiler class
+ *
+ * A subclass of QObject that compiles and links fragment
+ * shaders on its own thread with a context that shares
+ * its objects with the context of a Renderer. Only the
+ * newest queued code is compiled; results are collected
+ * by the renderer at a frame boundary.
+ */
+class ShaderCompiler : public QObject
+{
+    Q_OBJECT
+public:
+    typedef QList<QPair<QString, QString>> ImageList;
+
+    explicit ShaderCompiler(QObject *parent = 0);
+    ~ShaderCompiler();
+    bool createContext(QOpenGLContext *);
+    void queueCode(const QString &, const QString &);
+    QList<CompiledShader*> takeResults();
+    void forgetLastCode();
+    static CompiledShader *compile(const QString &, const QString &);
+    static CompiledShader *preprocess(const QString &, const QString &, ImageList &);
+    static const char *defaultVertexShader, *defaultFragmentShader;
+    static const char *builtinBlockName;
+    static const int cacheSize;
+    static const int maximumVertexCount;
+    static const int maximumStorageBuffers;
+    static const int maximumComputeGroups;
+
+Q_SIGNALS:
+    void compiled();
+
+public Q_SLOTS:
+    void release();
+
+private Q_SLOTS:
+    void compilePending();
+
+private:
+    static bool declareStorageBuffers(CompiledShader *, QString &);
+    static bool splitPasses(CompiledShader *);
+    static bool splitComputeStage(CompiledShader *, ShaderPass &);
+    static bool splitVertexStage(CompiledShader *, ShaderPass &);
+    static bool declareBuiltins(QString &);
+    static bool link(CompiledShader *, ShaderPass &, QOpenGLShader *, ProgramBinaryCache *);
+    static QFuture<QImage> decodeTextures(const ImageList &, QStringList &);
+    static bool loadTextures(CompiledShader *, const ImageList &, const QStringList &, QFuture<QImage>);
+
+    QOpenGLContext *context;
+    QOffscreenSurface *surface;
+
+    QMutex mutex;
+    QPair<QString, QString> pendingCode;
+    bool hasPendingCode;
+    QQueue<CompiledShader*> results;
+
+    QOpenGLShader *vertexShader;
+    ProgramBinaryCache *binaries;
+    QCache<QByteArray, QSharedPointer<QOpenGLShaderProgram>> programs;
+    QByteArray lastKey;
+};
+
+#endif // SHADERCOMPILER_HPP
@@ -0,0 +1,148 @@
+#include "ShaderLiterals.hpp"
+
+const char *ShaderLiterals::arrayName = "vetoLiterals";
+const int ShaderLiterals::maximumLiterals = 256;
+
+static const char components[] = "xyzw";
+
+/**
+ * @brief isIdentifier
+ * @param c Any character
+ * @return True if c can be part of an identifier
+ */
+static bool isIdentifier(QChar c){
+    return c.isLetterOrNumber() || c == '_';
+}
+
+/**
+ * @brief ShaderLiterals::hoist
+ * @param source Shader code
+ * @param values Receives the value of each hoisted literal
+ * @return source with the hoisted literals replaced by elements of the array
+ *
+ * Replace the float literals in function bodies, outside of const
+ * declarations, by components of the vec4 array named arrayName,
+ * four literals per element. At most maximumLiterals literals are
+ * hoisted; the others stay. Comments and directives are skipped.
+ * The lines of the code are kept.
+ */
+QString ShaderLiterals::hoist(const QString &source, QVector<float> &values){
+    values.clear();
+    QString hoisted;
+    hoisted.reserve(source.length());
+
+    int depth = 0;
+    bool constant = false, lineStart = true;
+    const int length = source.length();
+    int i = 0;
+    while(i < length){
+        const QChar c = source[i];
+        int end = i + 1;
+        if(c == '/' && i + 1 < length && source[i + 1] == '/'){
+            while(end < length && source[end] != '\n')
+                ++end;
+        }else if(c == '/' && i + 1 < length && source[i + 1] == '*'){
+            end = source.indexOf("*/", i + 2);
+            end = end < 0 ? length : end + 2;
+        }else if(c == '#' && lineStart){
+            // directives end with the line unless it is continued
+            while(end < length && (source[end] != '\n' || source[end - 1] == '\\'))
+                ++end;
+        }else if(c.isLetter() || c == '_'){
+            while(end < length && isIdentifier(source[end]))
+                ++end;
+            if(source.midRef(i, end - i) == QLatin1String("const"))
+                constant = true;
+        }else if(c.isDigit() || (c == '.' && i + 1 < length && source[i + 1].isDigit())){
+            bool hex = c == '0' && i + 1 < length && (source[i + 1] == 'x' || source[i + 1] == 'X');
+            bool floating = false;
+            if(hex)
+                end = i + 2;
+            while(end < length){
+                const QChar n = source[end];
+                if(n.isDigit() || (hex && isIdentifier(n))){
+                    ++end;
+                }else if(!hex && n == '.'){
+                    floating = true;
+                    ++end;
+                }else if(!hex && (n == 'e' || n == 'E')){
+                    floating = true;
+                    ++end;
+                    if(end < length && (source[end] == '+' || source[end] == '-'))
+                        ++end;
+                }else{
+                    break;
+                }
+            }
+            int numberEnd = end;
+            // suffixes; doubles are not hoisted into the float array
+            bool isDouble = false;
+            while(end < length && isIdentifier(source[end])){
+                isDouble = isDouble || source[end] == 'l' || source[end] == 'L';
+                ++end;
+            }
+            bool valid = false;
+            const float value = source.mid(i, numberEnd - i).toFloat(&valid);
+            if(floating && !isDouble && valid && depth > 0 && !constant && values.size() < maximumLiterals){
+                const int index = values.size();
+                values.append(value);
+                hoisted += QString("%1[%2].%3").arg(arrayName).arg(index / 4).arg(components[index % 4]);
+                i = end;
+                lineStart = false;
+                continue;
+            }
+        }else if(c == '{'){
+            ++depth;
+        }else if(c == '}'){
+            depth = qMax(0, depth - 1);
+            constant = false;
+        }else if(c == ';'){
+            constant = false;
+        }
+
+        hoisted += source.midRef(i, end - i);
+        if(c == '\n' || (end > i + 1 && source[end - 1] == '\n'))
+            lineStart = true;
+        else if(!c.isSpace())
+            lineStart = false;
+        i = end;
+    }
+    return hoisted;
+}
+
+/**
+ * @brief ShaderLiterals::declare
+ * @param source Hoisted code; receives the declaration of the array
+ * @param count Number of hoisted literals
+ * @return True if the array is declared, false if there are no literals or no place for it
+ *
+ * Declare the array in front of the first line after the leading
+ * directives, on that line, so the lines of the code are kept.
+ */
+bool ShaderLiterals::declare(QString &source, int count){
+    if(count <= 0)
+        return false;
+    QStringList lines = source.split('\n');
+    int line = 0;
+    while(line < lines.length() && lines[line].trimmed().startsWith('#'))
+        ++line;
+    int first = 0;
+    for(int i = 0; i < line; ++i)
+        first += lines[i].length() + 1;
+    if(first > source.length())
+        return false;
+    source.insert(first, QString("uniform vec4 %1[%2]; ").arg(arrayName).arg((count + 3) / 4));
+    return true;
+}
+
+/**
+ * @brief ShaderLiterals::pack
+ * @param values Values of the hoisted literals
+ * @return The values padded to whole vec4 elements
+ */
+QVector<float> ShaderLiterals::pack(const QVector<float> &values){
+    QVector<float> packed = values;
+    while(packed.size() % 4)
+        packed.append(0);
+    return packed;
+}
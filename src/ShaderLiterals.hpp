@@ -0,0 +1,30 @@
+#ifndef SHADERLITERALS_HPP
+#define SHADERLITERALS_HPP
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+
+/**
+ * @brief The ShaderLiterals class
+ *
+ * Hoists the float literals of shader code into a uniform array,
+ * so that edits which only change numbers can be applied by
+ * writing the array instead of compiling. Only literals inside
+ * function bodies are hoisted, since constant expressions, global
+ * initializers and directives can not refer to uniforms; literals
+ * of const declarations stay as well. Two versions of a shader that
+ * hoist to the same code differ in their literals only.
+ */
+class ShaderLiterals
+{
+public:
+    static QString hoist(const QString &, QVector<float> &);
+    static bool declare(QString &, int);
+    static QVector<float> pack(const QVector<float> &);
+
+    static const char *arrayName;
+    static const int maximumLiterals;
+};
+
+#endif // SHADERLITERALS_HPP
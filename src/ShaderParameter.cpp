@@ -0,0 +1,63 @@
+#include "ShaderParameter.hpp"
+
+#include <cmath>
+
+/**
+ * @brief ShaderParameter::clamp
+ * @param input Any value
+ * @return input limited to the range, rounded for int parameters
+ */
+float ShaderParameter::clamp(float input) const{
+    float clamped = qBound(minimum, input, maximum);
+    if(type == Int)
+        clamped = qBound(minimum, float(qRound(clamped)), maximum);
+    return clamped;
+}
+
+/**
+ * @brief ShaderParameter::parse
+ * @param source Shader code
+ * @return The annotated uniforms in the order of their declarations
+ *
+ * Find the float and int uniform declarations that are followed
+ * by a comment with "@range MINIMUM MAXIMUM" on the same line and
+ * read an optional "@default VALUE" from the comment as well.
+ * Ranges that are empty or reversed and names that were annotated
+ * before are skipped.
+ */
+QList<ShaderParameter> ShaderParameter::parse(const QString &source){
+    const QString number("([-+]?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][-+]?\\d+)?)");
+    QRegExp declarationRegEx("\\buniform\\s+(float|int)\\s+([A-Za-z_][A-Za-z0-9_]*)\\s*;[ \\t]*//([^\\n\\r]*)");
+    QRegExp rangeRegEx("@range\\s+" + number + "\\s+" + number);
+    QRegExp defaultRegEx("@default\\s+" + number);
+
+    QList<ShaderParameter> parameters;
+    int pos = 0;
+    while((pos = declarationRegEx.indexIn(source, pos)) != -1){
+        pos += declarationRegEx.matchedLength();
+        const QString comment = declarationRegEx.cap(3);
+        if(rangeRegEx.indexIn(comment) == -1)
+            continue;
+
+        ShaderParameter parameter;
+        parameter.name = declarationRegEx.cap(2);
+        parameter.type = declarationRegEx.cap(1) == "int" ? Int : Float;
+        parameter.minimum = rangeRegEx.cap(1).toFloat();
+        parameter.maximum = rangeRegEx.cap(2).toFloat();
+        if(parameter.type == Int){
+            parameter.minimum = std::ceil(parameter.minimum);
+            parameter.maximum = std::floor(parameter.maximum);
+        }
+        bool known = false;
+        for(const ShaderParameter &other : parameters)
+            known = known || other.name == parameter.name;
+        if(known || !(parameter.minimum < parameter.maximum))
+            continue;
+
+        parameter.defaultValue = parameter.clamp(defaultRegEx.indexIn(comment) != -1 ?
+                                                 defaultRegEx.cap(1).toFloat() : 0);
+        parameter.value = parameter.defaultValue;
+        parameters.append(parameter);
+    }
+    return parameters;
+}
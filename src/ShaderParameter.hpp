@@ -0,0 +1,37 @@
+#ifndef SHADERPARAMETER_HPP
+#define SHADERPARAMETER_HPP
+
+#include <QMetaType>
+#include <QString>
+#include <QList>
+#include <QRegExp>
+
+/**
+ * @brief The ShaderParameter struct
+ *
+ * A uniform of a shader that is annotated to be set from the
+ * editor, as in "uniform float speed; // @range 0 10 @default 2".
+ * Float and int uniforms can be annotated; the default is optional
+ * and otherwise the value closest to 0. value is the value the
+ * renderer currently sets.
+ */
+struct ShaderParameter{
+    enum Type{ Float, Int };
+
+    ShaderParameter() :
+        type(Float), minimum(0), maximum(1), defaultValue(0), value(0)
+    { }
+    QString name;
+    Type type;
+    float minimum, maximum;
+    float defaultValue;
+    float value;
+
+    float clamp(float) const;
+    static QList<ShaderParameter> parse(const QString &);
+};
+
+Q_DECLARE_METATYPE(ShaderParameter)
+Q_DECLARE_METATYPE(QList<ShaderParameter>)
+
+#endif // SHADERPARAMETER_HPP
@@ -0,0 +1,96 @@
+#include "ShaderWatchdog.hpp"
+
+const int ShaderWatchdog::trustFrames = 60;
+
+/**
+ * @brief ShaderWatchdog::ShaderWatchdog
+ *
+ * Create a watchdog with a budget of 500 ms and a limit of 10 frames
+ */
+ShaderWatchdog::ShaderWatchdog() :
+    budgetTime(500),
+    overrunLimit(10),
+    overruns(0),
+    goodFrames(0),
+    worst(0)
+{ }
+
+/**
+ * @brief ShaderWatchdog::setBudget
+ * @param time Time a frame may take in milliseconds; 0 disables the watchdog
+ */
+void ShaderWatchdog::setBudget(qreal time){
+    budgetTime = qMax(qreal(0), time);
+    overruns = 0;
+    worst = 0;
+}
+
+/**
+ * @brief ShaderWatchdog::budget
+ * @return Time a frame may take in milliseconds; 0 if disabled
+ */
+qreal ShaderWatchdog::budget() const{
+    return budgetTime;
+}
+
+/**
+ * @brief ShaderWatchdog::setLimit
+ * @param frames Number of frames in a row over the budget that trip the watchdog
+ */
+void ShaderWatchdog::setLimit(int frames){
+    overrunLimit = qMax(1, frames);
+}
+
+/**
+ * @brief ShaderWatchdog::limit
+ * @return Number of frames in a row over the budget that trip the watchdog
+ */
+int ShaderWatchdog::limit() const{
+    return overrunLimit;
+}
+
+/**
+ * @brief ShaderWatchdog::addFrame
+ * @param time Time the last frame took in milliseconds
+ * @return True if the watchdog tripped with this frame
+ */
+bool ShaderWatchdog::addFrame(qreal time){
+    if(budgetTime <= 0 || time <= budgetTime){
+        ++goodFrames;
+        overruns = 0;
+        worst = 0;
+        return false;
+    }
+    worst = qMax(worst, time);
+    if(++overruns < overrunLimit)
+        return false;
+    overruns = 0;
+    return true;
+}
+
+/**
+ * @brief ShaderWatchdog::isTrusted
+ * @return True if the shader kept the budget for trustFrames frames
+ */
+bool ShaderWatchdog::isTrusted() const{
+    return goodFrames >= trustFrames;
+}
+
+/**
+ * @brief ShaderWatchdog::worstTime
+ * @return Longest frame time of the current run of frames over the budget
+ */
+qreal ShaderWatchdog::worstTime() const{
+    return worst;
+}
+
+/**
+ * @brief ShaderWatchdog::reset
+ *
+ * Start watching a new shader
+ */
+void ShaderWatchdog::reset(){
+    overruns = 0;
+    goodFrames = 0;
+    worst = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef SHADERWATCHDOG_HPP
+#define SHADERWATCHDOG_HPP
+
+#include <QtGlobal>
+
+/**
+ * @brief The ShaderWatchdog class
+ *
+ * Decides when a shader costs too much to keep running. Every
+ * frame time is compared to a budget; after limit frames in a row
+ * over it, the watchdog trips once and starts counting anew. A
+ * shader that stayed within the budget for trustFrames frames is
+ * trusted, so a renderer can fall back to it later. A budget of 0
+ * disables the watchdog, which then trusts every shader after
+ * trustFrames frames.
+ */
+class ShaderWatchdog
+{
+public:
+    ShaderWatchdog();
+    void setBudget(qreal);
+    qreal budget() const;
+    void setLimit(int);
+    int limit() const;
+    bool addFrame(qreal);
+    bool isTrusted() const;
+    qreal worstTime() const;
+    void reset();
+
+    static const int trustFrames;
+
+private:
+    qreal budgetTime;
+    int overrunLimit;
+    int overruns;
+    int goodFrames;
+    qreal worst;
+};
+
+#endif // SHADERWATCHDOG_HPP
@@ -0,0 +1,256 @@
+#include "SharedResources.hpp"
+
+typedef void (QOPENGLF_APIENTRYP TexStorage1D)(GLenum, GLsizei, GLenum, GLsizei);
+
+static const GLfloat quadVertices[] = {
+    1, 1,0,  1,-1,0, -1,1,0,
+    1,-1,0, -1,-1,0, -1,1,0
+};
+static const GLfloat quadUvs[] = {
+    1,0, 1,1, 0,0,
+    1,1, 0,1, 0,0
+};
+
+const int SharedResources::audioTextureSize = 1024;
+
+QMutex SharedResources::mutex;
+QHash<QOpenGLContextGroup*, QWeakPointer<SharedResources>> SharedResources::resources;
+
+/**
+ * @brief SharedResources::SharedResources
+ *
+ * Create empty resources; create() allocates the GL objects
+ */
+SharedResources::SharedResources() :
+    vertices(0), uvs(0),
+    currentSet(0),
+    uploaded(false),
+    legacyAudio(false),
+    audioSequence(0),
+    audioFrames(4 * audioTextureSize, 0.f)
+{ }
+
+/**
+ * @brief SharedResources::acquire
+ * @param gl Functions of the current context
+ * @return The resources of the current share group or a null pointer without OpenGL 3.3
+ *
+ * Look up the resources of the share group of the current
+ * context and create them if nobody holds them yet
+ */
+QSharedPointer<SharedResources> SharedResources::acquire(QOpenGLFunctions_3_3_Core *gl){
+    QOpenGLContextGroup *group = QOpenGLContextGroup::currentContextGroup();
+    if(!gl || !group)
+        return QSharedPointer<SharedResources>();
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<SharedResources> shared = resources.value(group).toStrongRef();
+    if(shared)
+        return shared;
+
+    shared = QSharedPointer<SharedResources>(new SharedResources(), destroy);
+    shared->create(gl);
+
+    // drop the entries of share groups nobody holds anymore
+    for(auto it = resources.begin(); it != resources.end();){
+        if(it.value().isNull())
+            it = resources.erase(it);
+        else
+            ++it;
+    }
+    resources.insert(group, shared.toWeakRef());
+    return shared;
+}
+
+/**
+ * @brief SharedResources::vertexBuffer
+ * @return Buffer with the positions of the screen filling quad
+ */
+GLuint SharedResources::vertexBuffer() const{
+    return vertices;
+}
+
+/**
+ * @brief SharedResources::uvBuffer
+ * @return Buffer with the texture coordinates of the screen filling quad
+ */
+GLuint SharedResources::uvBuffer() const{
+    return uvs;
+}
+
+/**
+ * @brief SharedResources::audioTextures
+ * @param gl Functions of the current context
+ * @param input Audio input to read from or 0 for silence
+ * @param legacy True if the planar audioLeft and audioRight textures are needed
+ * @return The audio textures to sample in this frame
+ *
+ * Upload the latest audio unless another renderer has done so
+ * already and make the current context wait on the GPU for the
+ * upload to finish. Once a renderer asked for the planar textures,
+ * they are uploaded for everyone.
+ */
+SharedResources::AudioTextures SharedResources::audioTextures(QOpenGLFunctions_3_3_Core *gl, AudioInputProcessor *input, bool legacy){
+    QMutexLocker locker(&audioMutex);
+    bool changed = !uploaded || (legacy && !legacyAudio);
+    legacyAudio = legacyAudio || legacy;
+    if(input){
+        quint64 sequence = input->readLatest(audioFrames.data(), audioTextureSize);
+        changed = changed || sequence != audioSequence;
+        audioSequence = sequence;
+    }
+    if(changed)
+        upload(gl);
+
+    AudioSet &set = sets[currentSet];
+    if(set.fence)
+        gl->glWaitSync(set.fence, 0, GL_TIMEOUT_IGNORED);
+    return set.textures;
+}
+
+/**
+ * @brief SharedResources::create
+ * @param gl Functions of the current context
+ *
+ * Allocate the quad buffers and the pixel buffers of the audio
+ * sets; the audio textures are created on their first upload
+ */
+void SharedResources::create(QOpenGLFunctions_3_3_Core *gl){
+    gl->glGenBuffers(1, &vertices);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, vertices);
+    gl->glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+
+    gl->glGenBuffers(1, &uvs);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, uvs);
+    gl->glBufferData(GL_ARRAY_BUFFER, sizeof(quadUvs), quadUvs, GL_STATIC_DRAW);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    for(AudioSet &set : sets){
+        gl->glGenBuffers(1, &set.pixelBuffer);
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, set.pixelBuffer);
+        gl->glBufferData(GL_PIXEL_UNPACK_BUFFER, audioFrames.size() * sizeof(float), 0, GL_STREAM_DRAW);
+    }
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+/**
+ * @brief SharedResources::upload
+ * @param gl Functions of the current context
+ *
+ * Write the audio frames into the oldest set, interleaved into the
+ * RG texture and planar into the legacy ones, and make it current.
+ * The fence is flushed, so other contexts can wait for it. Nothing
+ * waits for contexts that may still sample the oldest set.
+ */
+void SharedResources::upload(QOpenGLFunctions_3_3_Core *gl){
+    const int next = (currentSet + 1) % audioSets;
+    AudioSet &set = sets[next];
+    if(set.fence){
+        gl->glDeleteSync(set.fence);
+        set.fence = 0;
+    }
+
+    if(!set.textures.audio)
+        set.textures.audio = createAudioTexture(gl, GL_RG32F);
+    int size = 2 * audioTextureSize;
+    if(legacyAudio){
+        if(!set.textures.left){
+            set.textures.left = createAudioTexture(gl, GL_R32F);
+            set.textures.right = createAudioTexture(gl, GL_R32F);
+        }
+        float *frames = audioFrames.data();
+        float *left = frames + 2 * audioTextureSize, *right = left + audioTextureSize;
+        for(int i = 0; i < audioTextureSize; ++i){
+            left[i]  = frames[2*i];
+            right[i] = frames[2*i+1];
+        }
+        size = 4 * audioTextureSize;
+    }
+
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, set.pixelBuffer);
+    gl->glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size * sizeof(float), audioFrames.data());
+
+    gl->glBindTexture(GL_TEXTURE_1D, set.textures.audio);
+    gl->glTexSubImage1D(GL_TEXTURE_1D, 0, 0, audioTextureSize, GL_RG, GL_FLOAT, 0);
+
+    if(legacyAudio){
+        const quintptr planeSize = audioTextureSize * sizeof(float);
+        gl->glBindTexture(GL_TEXTURE_1D, set.textures.left);
+        gl->glTexSubImage1D(GL_TEXTURE_1D, 0, 0, audioTextureSize, GL_RED, GL_FLOAT,
+                            reinterpret_cast<const GLvoid*>(2 * planeSize));
+
+        gl->glBindTexture(GL_TEXTURE_1D, set.textures.right);
+        gl->glTexSubImage1D(GL_TEXTURE_1D, 0, 0, audioTextureSize, GL_RED, GL_FLOAT,
+                            reinterpret_cast<const GLvoid*>(3 * planeSize));
+    }
+    gl->glBindTexture(GL_TEXTURE_1D, 0);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    set.fence = gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // other contexts only see the fence once it is flushed
+    gl->glFlush();
+    currentSet = next;
+    uploaded = true;
+}
+
+/**
+ * @brief SharedResources::createAudioTexture
+ * @param gl Functions of the current context
+ * @param internalFormat Format of the texels
+ * @return A linearly filtered 1D texture of audioTextureSize texels,
+ * immutable if the driver supports texture storage
+ */
+GLuint SharedResources::createAudioTexture(QOpenGLFunctions_3_3_Core *gl, GLenum internalFormat){
+    GLuint texture = 0;
+    gl->glGenTextures(1, &texture);
+    gl->glBindTexture(GL_TEXTURE_1D, texture);
+    gl->glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    allocateTexture1D(internalFormat, audioTextureSize);
+    return texture;
+}
+
+/**
+ * @brief SharedResources::allocateTexture1D
+ * @param internalFormat Format of the texels
+ * @param size Number of texels
+ *
+ * Allocate the texels of the 1D texture bound in the current
+ * context; immutable if the driver supports texture storage
+ */
+void SharedResources::allocateTexture1D(GLenum internalFormat, GLsizei size){
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    TexStorage1D texStorage1D = 0;
+    if(context->format().version() >= qMakePair(4, 2) || context->hasExtension("GL_ARB_texture_storage"))
+        texStorage1D = reinterpret_cast<TexStorage1D>(context->getProcAddress("glTexStorage1D"));
+    if(texStorage1D)
+        texStorage1D(GL_TEXTURE_1D, 1, internalFormat, size);
+    else
+        glTexImage1D(GL_TEXTURE_1D, 0, internalFormat, size, 0, GL_RED, GL_FLOAT, 0);
+}
+
+/**
+ * @brief SharedResources::destroy
+ * @param shared Resources nobody holds anymore
+ *
+ * Free the GL objects with the current context
+ */
+void SharedResources::destroy(SharedResources *shared){
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    QOpenGLFunctions_3_3_Core *gl = context ? context->versionFunctions<QOpenGLFunctions_3_3_Core>() : 0;
+    if(gl && gl->initializeOpenGLFunctions()){
+        gl->glDeleteBuffers(1, &shared->vertices);
+        gl->glDeleteBuffers(1, &shared->uvs);
+        for(AudioSet &set : shared->sets){
+            gl->glDeleteBuffers(1, &set.pixelBuffer);
+            GLuint textures[] = {set.textures.audio, set.textures.left, set.textures.right};
+            gl->glDeleteTextures(3, textures);
+            if(set.fence)
+                gl->glDeleteSync(set.fence);
+        }
+    }else{
+        qWarning() << "Releasing shared resources without a current context; they leak.";
+    }
+    delete shared;
+}
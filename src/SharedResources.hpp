@@ -0,0 +1,89 @@
+#ifndef SHAREDRESOURCES_HPP
+#define SHAREDRESOURCES_HPP
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QMutex>
+#include <QHash>
+#include <QDebug>
+#include <vector>
+
+#include "AudioInputProcessor.hpp"
+
+/**
+ * @brief The SharedResources class
+ *
+ * The GL objects that all renderers of a share group use
+ * together: the buffers of the screen filling quad and the
+ * textures with the latest audio frames. They are created for
+ * the first renderer that acquires them and freed with the last
+ * reference, which needs a current context of the group. New
+ * audio is uploaded once, by the first renderer that asks for it
+ * after it was captured. Uploads rotate through audioSets sets of
+ * textures and each one is fenced, so a renderer does not sample a
+ * set before its upload is done. Readers are not fenced: a set is
+ * only written again two uploads later, which leaves other contexts
+ * that much time to finish their frames, but does not make them
+ * wait. Vertex arrays, programs
+ * and framebuffers can not be shared and stay with each renderer.
+ * Thread-safe.
+ */
+class SharedResources
+{
+public:
+    /**
+     * @brief The AudioTextures struct
+     *
+     * The audio textures to sample in the current frame; the
+     * planar ones are 0 unless a renderer asked for them
+     */
+    struct AudioTextures{
+        AudioTextures() : audio(0), left(0), right(0) { }
+        GLuint audio, left, right;
+    };
+
+    static QSharedPointer<SharedResources> acquire(QOpenGLFunctions_3_3_Core *);
+    GLuint vertexBuffer() const;
+    GLuint uvBuffer() const;
+    AudioTextures audioTextures(QOpenGLFunctions_3_3_Core *, AudioInputProcessor *, bool);
+    static void allocateTexture1D(GLenum, GLsizei);
+
+    static const int audioTextureSize;
+    static const int audioSets = 3;
+
+private:
+    /**
+     * @brief The AudioSet struct
+     *
+     * One set of audio textures with the pixel buffer it is
+     * uploaded through and the fence of its last upload
+     */
+    struct AudioSet{
+        AudioSet() : pixelBuffer(0), fence(0) { }
+        GLuint pixelBuffer;
+        AudioTextures textures;
+        GLsync fence;
+    };
+
+    SharedResources();
+    void create(QOpenGLFunctions_3_3_Core *);
+    void upload(QOpenGLFunctions_3_3_Core *);
+    static GLuint createAudioTexture(QOpenGLFunctions_3_3_Core *, GLenum);
+    static void destroy(SharedResources *);
+
+    GLuint vertices, uvs;
+    QMutex audioMutex;
+    AudioSet sets[audioSets];
+    int currentSet;
+    bool uploaded;
+    bool legacyAudio;
+    quint64 audioSequence;
+    std::vector<float> audioFrames;
+
+    static QMutex mutex;
+    static QHash<QOpenGLContextGroup*, QWeakPointer<SharedResources>> resources;
+};
+
+#endif // SHAREDRESOURCES_HPP
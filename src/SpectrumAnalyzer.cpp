@@ -0,0 +1,190 @@
+#include "SpectrumAnalyzer.hpp"
+
+const int SpectrumAnalyzer::minimumSize = 64;
+const int SpectrumAnalyzer::maximumSize = 4096;
+
+/**
+ * @brief SpectrumAnalyzer::SpectrumAnalyzer
+ * @param size Number of frames per transform; 0 disables the analyzer
+ * @param smoothing Weight of the previous spectrum, in [0, 1)
+ */
+SpectrumAnalyzer::SpectrumAnalyzer(int size, float smoothing) :
+    fftSize(0),
+    smoothingFactor(0)
+{
+    setSize(size);
+    setSmoothing(smoothing);
+}
+
+/**
+ * @brief SpectrumAnalyzer::setSize
+ * @param size Number of frames per transform; 0 disables the analyzer
+ *
+ * Plan the transform for size frames. The size is rounded up to
+ * a power of two within [minimumSize, maximumSize]. Changing the
+ * size resets the smoothed spectrum.
+ */
+void SpectrumAnalyzer::setSize(int size){
+    int newSize = size > 0 ? roundSize(size) : 0;
+    if(newSize == fftSize)
+        return;
+    fftSize = newSize;
+
+    bitReversed.assign(fftSize, 0);
+    window.assign(fftSize, 0.f);
+    twiddleReal.assign(fftSize, 0.f);
+    twiddleImag.assign(fftSize, 0.f);
+    real.assign(fftSize, 0.f);
+    imag.assign(fftSize, 0.f);
+    leftMagnitudes.assign(fftSize / 2, 0.f);
+    rightMagnitudes.assign(fftSize / 2, 0.f);
+    if(!fftSize)
+        return;
+
+    int bits = 0;
+    while((1 << bits) < fftSize)
+        ++bits;
+    for(int i = 0; i < fftSize; ++i){
+        int reversed = 0;
+        for(int bit = 0; bit < bits; ++bit)
+            if(i & (1 << bit))
+                reversed |= 1 << (bits - 1 - bit);
+        bitReversed[i] = reversed;
+        window[i] = float(0.5 - 0.5 * std::cos(2 * M_PI * i / fftSize));
+    }
+
+    // the twiddle factors of the stage with butterfly span half start at index half
+    for(int half = 1; half < fftSize; half *= 2)
+        for(int j = 0; j < half; ++j){
+            twiddleReal[half + j] = float(std::cos(-M_PI * j / half));
+            twiddleImag[half + j] = float(std::sin(-M_PI * j / half));
+        }
+}
+
+/**
+ * @brief SpectrumAnalyzer::roundSize
+ * @param size Requested number of frames per transform
+ * @return The next power of two within [minimumSize, maximumSize]
+ */
+int SpectrumAnalyzer::roundSize(int size){
+    int rounded = minimumSize;
+    while(rounded < size && rounded < maximumSize)
+        rounded *= 2;
+    return rounded;
+}
+
+/**
+ * @brief SpectrumAnalyzer::setSmoothing
+ * @param smoothing Weight of the previous spectrum, in [0, 1)
+ */
+void SpectrumAnalyzer::setSmoothing(float smoothing){
+    smoothingFactor = qBound(0.f, smoothing, 0.99f);
+}
+
+/**
+ * @brief SpectrumAnalyzer::size
+ * @return Number of frames per transform; 0 if disabled
+ */
+int SpectrumAnalyzer::size() const{
+    return fftSize;
+}
+
+/**
+ * @brief SpectrumAnalyzer::bins
+ * @return Number of magnitude bins per channel
+ */
+int SpectrumAnalyzer::bins() const{
+    return fftSize / 2;
+}
+
+/**
+ * @brief SpectrumAnalyzer::smoothing
+ * @return Weight of the previous spectrum
+ */
+float SpectrumAnalyzer::smoothing() const{
+    return smoothingFactor;
+}
+
+/**
+ * @brief SpectrumAnalyzer::left
+ * @return bins() magnitudes of the left channel, lowest frequency first
+ */
+const float *SpectrumAnalyzer::left() const{
+    return leftMagnitudes.data();
+}
+
+/**
+ * @brief SpectrumAnalyzer::right
+ * @return bins() magnitudes of the right channel, lowest frequency first
+ */
+const float *SpectrumAnalyzer::right() const{
+    return rightMagnitudes.data();
+}
+
+/**
+ * @brief SpectrumAnalyzer::analyze
+ * @param frames size() stereo frames, left and right interleaved
+ *
+ * Transform the frames and blend their magnitudes into the
+ * spectrum. A full scale sine yields a magnitude of about 1.
+ */
+void SpectrumAnalyzer::analyze(const float *frames){
+    if(!fftSize)
+        return;
+
+    for(int i = 0; i < fftSize; ++i){
+        real[bitReversed[i]] = frames[2*i]   * window[i];
+        imag[bitReversed[i]] = frames[2*i+1] * window[i];
+    }
+    transform();
+
+    // Z = L + iR, so L[k] = (Z[k] + conj(Z[N-k])) / 2 and R[k] = (Z[k] - conj(Z[N-k])) / 2i
+    const float scale = 2.f / fftSize; // includes the coherent gain of the Hann window
+    const float keep = smoothingFactor, take = 1.f - smoothingFactor;
+    for(int k = 0; k < fftSize / 2; ++k){
+        int mirrored = (fftSize - k) & (fftSize - 1);
+        float leftReal  = real[k] + real[mirrored], leftImag  = imag[k] - imag[mirrored];
+        float rightReal = imag[k] + imag[mirrored], rightImag = real[mirrored] - real[k];
+        float left  = scale * std::sqrt(leftReal * leftReal + leftImag * leftImag);
+        float right = scale * std::sqrt(rightReal * rightReal + rightImag * rightImag);
+        leftMagnitudes[k]  = keep * leftMagnitudes[k]  + take * left;
+        rightMagnitudes[k] = keep * rightMagnitudes[k] + take * right;
+    }
+}
+
+/**
+ * @brief SpectrumAnalyzer::transform
+ *
+ * In-place FFT of the bit reversed input in real and imag
+ */
+void SpectrumAnalyzer::transform(){
+    float *re = real.data(), *im = imag.data();
+    for(int half = 1; half < fftSize; half *= 2){
+        const float *wRe = twiddleReal.data() + half, *wIm = twiddleImag.data() + half;
+        for(int start = 0; start < fftSize; start += 2 * half){
+            float *aRe = re + start, *aIm = im + start, *bRe = aRe + half, *bIm = aIm + half;
+            int j = 0;
+#ifdef __SSE2__
+            for(; j + 4 <= half; j += 4){
+                __m128 wr = _mm_loadu_ps(wRe + j), wi = _mm_loadu_ps(wIm + j);
+                __m128 br = _mm_loadu_ps(bRe + j), bi = _mm_loadu_ps(bIm + j);
+                __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+                __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+                __m128 ar = _mm_loadu_ps(aRe + j), ai = _mm_loadu_ps(aIm + j);
+                _mm_storeu_ps(aRe + j, _mm_add_ps(ar, tr));
+                _mm_storeu_ps(aIm + j, _mm_add_ps(ai, ti));
+                _mm_storeu_ps(bRe + j, _mm_sub_ps(ar, tr));
+                _mm_storeu_ps(bIm + j, _mm_sub_ps(ai, ti));
+            }
+#endif
+            for(; j < half; ++j){
+                float tr = bRe[j] * wRe[j] - bIm[j] * wIm[j];
+                float ti = bRe[j] * wIm[j] + bIm[j] * wRe[j];
+                bRe[j] = aRe[j] - tr;
+                bIm[j] = aIm[j] - ti;
+                aRe[j] += tr;
+                aIm[j] += ti;
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SPECTRUMANALYZER_HPP
+#define SPECTRUMANALYZER_HPP
+
+#include <QtGlobal>
+#include <vector>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief The SpectrumAnalyzer class
+ *
+ * Computes the magnitude spectrum of interleaved stereo frames
+ * with a Hann window and a radix-2 FFT. Both channels share one
+ * complex transform: left is fed as real and right as imaginary
+ * part and the two spectra are separated afterwards. Bit reversal
+ * and twiddle factors are planned once per size; the butterflies
+ * run four at a time with SSE2 where available. Successive spectra
+ * are blended exponentially by the smoothing factor.
+ * Not thread-safe.
+ */
+class SpectrumAnalyzer
+{
+public:
+    explicit SpectrumAnalyzer(int size = 0, float smoothing = 0.f);
+    void setSize(int);
+    void setSmoothing(float);
+    int size() const;
+    int bins() const;
+    float smoothing() const;
+    void analyze(const float *);
+    const float *left() const;
+    const float *right() const;
+    static int roundSize(int);
+    static const int minimumSize, maximumSize;
+
+private:
+    void transform();
+
+    int fftSize;
+    float smoothingFactor;
+    std::vector<int> bitReversed;
+    std::vector<float> window, twiddleReal, twiddleImag;
+    std::vector<float> real, imag;
+    std::vector<float> leftMagnitudes, rightMagnitudes;
+};
+
+#endif // SPECTRUMANALYZER_HPP
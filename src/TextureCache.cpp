@@ -0,0 +1,162 @@
+#include "TextureCache.hpp"
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+
+QMutex TextureCache::mutex;
+QHash<QString, QWeakPointer<SharedTexture>> TextureCache::textures;
+
+/**
+ * @brief TextureCache::key
+ * @param file The image file
+ * @param options Sampler options of the texture
+ * @return The key of the texture for the current share group
+ */
+QString TextureCache::key(const QFileInfo &file, const Options &options){
+    return QString("%1|%2|%3|%4|%5|%6")
+            .arg(quintptr(QOpenGLContextGroup::currentContextGroup()))
+            .arg(file.absoluteFilePath())
+            .arg(file.lastModified().toMSecsSinceEpoch())
+            .arg(options.minification)
+            .arg(options.magnification)
+            .arg(options.wrap);
+}
+
+/**
+ * @brief TextureCache::texture
+ * @param path Path of the image file
+ * @param options Sampler options of the texture
+ * @return The texture or a null pointer if the image can not be read
+ *
+ * Look up the texture for the current share group and load
+ * it if it is not cached yet or the file has changed since.
+ */
+QSharedPointer<SharedTexture> TextureCache::texture(const QString &path, const Options &options){
+    QSharedPointer<SharedTexture> texture = cached(path, options);
+    if(texture)
+        return texture;
+    return insert(path, decode(path), options);
+}
+
+/**
+ * @brief TextureCache::cached
+ * @param path Path of the image file
+ * @param options Sampler options of the texture
+ * @return The texture or a null pointer if it is not cached
+ *
+ * Look up the texture for the current share group
+ */
+QSharedPointer<SharedTexture> TextureCache::cached(const QString &path, const Options &options){
+    QMutexLocker locker(&mutex);
+    return textures.value(key(QFileInfo(path), options)).toStrongRef();
+}
+
+/**
+ * @brief TextureCache::decode
+ * @param path Path of the image file
+ * @return The image as expected by insert() or a null image on failure
+ *
+ * Read the image file. Needs no context, so it can run on a thread pool.
+ * Like QOpenGLTexture, the image is mirrored so that uv (0, 0) is its
+ * bottom left corner.
+ */
+QImage TextureCache::decode(const QString &path){
+    QImage image(path);
+    if(image.isNull())
+        return image;
+    return image.mirrored().convertToFormat(QImage::Format_RGBA8888);
+}
+
+/**
+ * @brief TextureCache::insert
+ * @param path Path of the image file
+ * @param image The image returned by decode()
+ * @param options Sampler options of the texture
+ * @return The texture or a null pointer if image is null
+ *
+ * Upload the image for the current share group, unless
+ * another thread has done so in the meantime.
+ */
+QSharedPointer<SharedTexture> TextureCache::insert(const QString &path, const QImage &image, const Options &options){
+    if(image.isNull())
+        return QSharedPointer<SharedTexture>();
+
+    QString textureKey = key(QFileInfo(path), options);
+    QSharedPointer<SharedTexture> texture = cached(path, options);
+    if(texture)
+        return texture;
+
+    texture = QSharedPointer<SharedTexture>(upload(image, options), destroy);
+
+    QMutexLocker locker(&mutex);
+    QSharedPointer<SharedTexture> other = textures.value(textureKey).toStrongRef();
+    if(other)
+        return other;
+
+    // drop the entries nobody holds anymore, including outdated versions of this file
+    for(auto it = textures.begin(); it != textures.end();){
+        if(it.value().isNull())
+            it = textures.erase(it);
+        else
+            ++it;
+    }
+
+    textures.insert(textureKey, texture.toWeakRef());
+    return texture;
+}
+
+/**
+ * @brief TextureCache::upload
+ * @param image The image returned by decode()
+ * @param options Sampler options of the texture
+ * @return A new texture with mipmaps
+ *
+ * Upload image with the current context through a pixel
+ * buffer object, so the driver can copy it asynchronously.
+ */
+SharedTexture *TextureCache::upload(const QImage &image, const Options &options){
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    QImage data = image.format() == QImage::Format_RGBA8888 ? image :
+                                                              image.convertToFormat(QImage::Format_RGBA8888);
+
+    GLuint pixelBuffer = 0;
+    gl->glGenBuffers(1, &pixelBuffer);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+    gl->glBufferData(GL_PIXEL_UNPACK_BUFFER, data.byteCount(), data.constBits(), GL_STREAM_DRAW);
+
+    SharedTexture *texture = new SharedTexture();
+    texture->size = data.size();
+    gl->glGenTextures(1, &texture->id);
+    gl->glBindTexture(GL_TEXTURE_2D, texture->id);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, data.width(), data.height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, options.minification);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, options.magnification);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, options.wrap);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, options.wrap);
+    if(options.minification != GL_LINEAR && options.minification != GL_NEAREST)
+        gl->glGenerateMipmap(GL_TEXTURE_2D);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    // the driver keeps the storage until the upload is done
+    gl->glDeleteBuffers(1, &pixelBuffer);
+    return texture;
+}
+
+/**
+ * @brief TextureCache::destroy
+ * @param texture Texture nobody holds anymore
+ *
+ * Free the texture with the current context
+ */
+void TextureCache::destroy(SharedTexture *texture){
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    if(context)
+        context->functions()->glDeleteTextures(1, &texture->id);
+    else
+        qWarning() << "Releasing a texture without a current context; texture" << texture->id << "leaks.";
+    delete texture;
+}
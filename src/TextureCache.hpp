@@ -0,0 +1,74 @@
+#ifndef TEXTURECACHE_HPP
+#define TEXTURECACHE_HPP
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QImage>
+#include <QMutex>
+#include <QHash>
+#include <QDebug>
+
+/**
+ * @brief The SharedTexture struct
+ *
+ * A 2D texture that may be used by every context of the
+ * share group it was created in. Unlike QOpenGLTexture it
+ * does not refer to the creating context, so it outlives it.
+ */
+struct SharedTexture{
+    SharedTexture() : id(0) { }
+    GLuint id;
+    QSize size;
+};
+
+/**
+ * @brief The TextureCache class
+ *
+ * A process-wide cache of the texture images used by
+ * #texture directives. Textures are shared by everyone
+ * who asks for the same file with the same sampler options
+ * from the same share group and are only loaded again once
+ * the file on disk changes. Entries live as long as someone
+ * holds the texture. Images can be decoded on any thread; the
+ * other calls need a current context and so does releasing the
+ * last reference to a texture. Thread-safe.
+ */
+class TextureCache
+{
+public:
+    /**
+     * @brief The Options struct
+     *
+     * Sampler state a cached texture is set up with
+     */
+    struct Options{
+        Options() :
+            minification(GL_LINEAR_MIPMAP_LINEAR),
+            magnification(GL_LINEAR),
+            wrap(GL_REPEAT)
+        { }
+        GLenum minification;
+        GLenum magnification;
+        GLenum wrap;
+    };
+
+    static QSharedPointer<SharedTexture> texture(const QString &, const Options &options = Options());
+    static QSharedPointer<SharedTexture> cached(const QString &, const Options &options = Options());
+    static QSharedPointer<SharedTexture> insert(const QString &, const QImage &, const Options &options = Options());
+    static QImage decode(const QString &);
+
+private:
+    TextureCache();
+    static QString key(const QFileInfo &, const Options &);
+    static SharedTexture *upload(const QImage &, const Options &);
+    static void destroy(SharedTexture *);
+
+    static QMutex mutex;
+    static QHash<QString, QWeakPointer<SharedTexture>> textures;
+};
+
+#endif // TEXTURECACHE_HPP
@@ -0,0 +1,153 @@
+#include "Timeline.hpp"
+
+/**
+ * @brief Timeline::Timeline
+ *
+ * Create a running real time timeline at 0
+ */
+Timeline::Timeline() :
+    position(0),
+    lastClock(-1),
+    step(0),
+    speedFactor(1),
+    paused(false)
+{ }
+
+/**
+ * @brief Timeline::restart
+ *
+ * Start the clock and move the timeline back to 0
+ */
+void Timeline::restart(){
+    clock.start();
+    position = 0;
+    lastClock = -1;
+}
+
+/**
+ * @brief Timeline::update
+ *
+ * Advance the timeline for a new frame by the time
+ * the clock measured since the last frame
+ */
+void Timeline::update(){
+    if(!clock.isValid())
+        clock.start();
+    update(clock.nsecsElapsed());
+}
+
+/**
+ * @brief Timeline::update
+ * @param now Reading of a monotonic clock in nanoseconds
+ *
+ * Advance the timeline for a new frame. The first
+ * update after a restart or resume only sets the
+ * reference for the next one.
+ */
+void Timeline::update(qint64 now){
+    if(!paused && lastClock >= 0){
+        if(step > 0)
+            position += qint64(step * speedFactor);
+        else
+            position += qint64((now - lastClock) * speedFactor);
+    }
+    lastClock = now;
+}
+
+/**
+ * @brief Timeline::pause
+ *
+ * Hold the timeline at its current time
+ */
+void Timeline::pause(){
+    paused = true;
+}
+
+/**
+ * @brief Timeline::resume
+ *
+ * Continue from the time the timeline was paused at
+ */
+void Timeline::resume(){
+    if(!paused)
+        return;
+    paused = false;
+    lastClock = -1;
+}
+
+/**
+ * @brief Timeline::togglePause
+ *
+ * Pause a running timeline and resume a paused one
+ */
+void Timeline::togglePause(){
+    if(paused)
+        resume();
+    else
+        pause();
+}
+
+/**
+ * @brief Timeline::isPaused
+ * @return True if the timeline does not advance
+ */
+bool Timeline::isPaused() const{
+    return paused;
+}
+
+/**
+ * @brief Timeline::seek
+ * @param time Time to move to in milliseconds; negative times are clamped to 0
+ */
+void Timeline::seek(double time){
+    position = qMax(qint64(0), qint64(time * 1000000));
+}
+
+/**
+ * @brief Timeline::setSpeed
+ * @param factor Factor the advance of every frame is scaled with;
+ *        0 holds the timeline, negative factors are clamped to 0
+ */
+void Timeline::setSpeed(double factor){
+    speedFactor = qMax(0.0, factor);
+}
+
+/**
+ * @brief Timeline::speed
+ * @return Factor the advance of every frame is scaled with
+ */
+double Timeline::speed() const{
+    return speedFactor;
+}
+
+/**
+ * @brief Timeline::setFixedStep
+ * @param time Advance per frame in milliseconds; 0 follows the clock
+ */
+void Timeline::setFixedStep(double time){
+    step = qMax(qint64(0), qint64(time * 1000000));
+}
+
+/**
+ * @brief Timeline::fixedStep
+ * @return Advance per frame in milliseconds; 0 if the timeline follows the clock
+ */
+double Timeline::fixedStep() const{
+    return step / 1000000.0;
+}
+
+/**
+ * @brief Timeline::nanoseconds
+ * @return Current time of the timeline in nanoseconds
+ */
+qint64 Timeline::nanoseconds() const{
+    return position;
+}
+
+/**
+ * @brief Timeline::milliseconds
+ * @return Current time of the timeline in milliseconds
+ */
+double Timeline::milliseconds() const{
+    return position / 1000000.0;
+}
@@ -0,0 +1,46 @@
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+
+/**
+ * @brief The Timeline class
+ *
+ * The time a Renderer shows, kept in nanoseconds so it stays
+ * exact for days. It advances once per frame, either by the
+ * time that passed on a monotonic clock or by a fixed step,
+ * scaled by a speed factor. The fixed step makes runs
+ * reproducible, since every frame shows a known time. The
+ * timeline can be paused, resumed and moved to any time; the
+ * wall clock time that passes while paused is skipped.
+ */
+class Timeline
+{
+public:
+    Timeline();
+    void restart();
+    void update();
+    void update(qint64);
+    void pause();
+    void resume();
+    void togglePause();
+    bool isPaused() const;
+    void seek(double);
+    void setSpeed(double);
+    double speed() const;
+    void setFixedStep(double);
+    double fixedStep() const;
+    qint64 nanoseconds() const;
+    double milliseconds() const;
+
+private:
+    QElapsedTimer clock;
+    qint64 position;
+    qint64 lastClock;
+    qint64 step;
+    double speedFactor;
+    bool paused;
+};
+
+#endif // TIMELINE_HPP
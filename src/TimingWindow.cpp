@@ -0,0 +1,80 @@
+#include "TimingWindow.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief TimingWindow::TimingWindow
+ * @param capacity Number of samples the window holds; at least one
+ */
+TimingWindow::TimingWindow(int capacity) :
+    samples(qMax(1, capacity), 0.0),
+    next(0),
+    filled(0)
+{ }
+
+/**
+ * @brief TimingWindow::add
+ * @param duration Measured duration; replaces the oldest one if the window is full
+ */
+void TimingWindow::add(double duration){
+    samples[next] = duration;
+    next = (next + 1) % int(samples.size());
+    filled = qMin(filled + 1, int(samples.size()));
+}
+
+/**
+ * @brief TimingWindow::clear
+ *
+ * Forget all samples
+ */
+void TimingWindow::clear(){
+    next = 0;
+    filled = 0;
+}
+
+/**
+ * @brief TimingWindow::count
+ * @return Number of samples in the window
+ */
+int TimingWindow::count() const{
+    return filled;
+}
+
+/**
+ * @brief TimingWindow::capacity
+ * @return Number of samples the window holds when full
+ */
+int TimingWindow::capacity() const{
+    return int(samples.size());
+}
+
+/**
+ * @brief TimingWindow::mean
+ * @return Average of the samples; 0 if there are none
+ */
+double TimingWindow::mean() const{
+    if(filled == 0)
+        return 0;
+    double sum = 0;
+    for(int i = 0; i < filled; ++i)
+        sum += samples[i];
+    return sum / filled;
+}
+
+/**
+ * @brief TimingWindow::percentile
+ * @param fraction Fraction of the samples that may not exceed the result, in [0, 1]
+ * @return Smallest sample that at least fraction of the samples do not exceed; 0 if there are none
+ *
+ * Uses the nearest rank, so the result is always one of the samples.
+ */
+double TimingWindow::percentile(qreal fraction) const{
+    if(filled == 0)
+        return 0;
+    std::vector<double> sorted(samples.begin(), samples.begin() + filled);
+    int rank = int(std::ceil(qBound(qreal(0), fraction, qreal(1)) * filled)) - 1;
+    rank = qBound(0, rank, filled - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
@@ -0,0 +1,32 @@
+#ifndef TIMINGWINDOW_HPP
+#define TIMINGWINDOW_HPP
+
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * @brief The TimingWindow class
+ *
+ * A rolling window over the last measured durations. Once
+ * the window is full, every new sample replaces the oldest
+ * one. Averages and percentiles refer to the samples that
+ * are currently in the window.
+ */
+class TimingWindow
+{
+public:
+    explicit TimingWindow(int capacity = 300);
+    void add(double);
+    void clear();
+    int count() const;
+    int capacity() const;
+    double mean() const;
+    double percentile(qreal) const;
+
+private:
+    std::vector<double> samples;
+    int next;
+    int filled;
+};
+
+#endif // TIMINGWINDOW_HPP
@@ -1,4 +1,5 @@
 #include <QTranslator>
+#include <QCommandLineParser>
 
 #include "EditorWindow.hpp"
 #include "Renderer.hpp"
@@ -7,6 +8,56 @@
 
 static const QString socketName = "VeTo";
 
+/**
+ * @brief renderHeadless
+ * @param app The running application
+ * @return 0 on success, otherwise 1
+ *
+ * Renders a GLSL file into an image sequence without opening
+ * any window. Triggered by the --render command line option.
+ */
+static int renderHeadless(QApplication &app){
+    QCommandLineParser parser;
+    parser.setApplicationDescription(app.tr("Renders a GLSL shader into numbered frames."));
+    parser.addHelpOption();
+
+    QCommandLineOption renderOption("render", app.tr("Render the shader in <file> without a window."), "file");
+    QCommandLineOption framesOption("frames", app.tr("Number of frames to render."), "count", "1");
+    QCommandLineOption stepOption("step", app.tr("Time between two frames in seconds."), "seconds", QString::number(1.0 / 60));
+    QCommandLineOption sizeOption("size", app.tr("Resolution of the frames."), "WxH", "800x600");
+    QCommandLineOption outputOption("output", app.tr("Output file; a .raw suffix writes raw RGBA frames."), "file", "frame.png");
+    parser.addOption(renderOption);
+    parser.addOption(framesOption);
+    parser.addOption(stepOption);
+    parser.addOption(sizeOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    QFile file(parser.value(renderOption));
+    if(!file.open(QFile::ReadOnly | QFile::Text)){
+        err << app.tr("Cannot read file %1: %2").arg(file.fileName()).arg(file.errorString()) << endl;
+        return 1;
+    }
+
+    bool framesOk, stepOk;
+    int frames = parser.value(framesOption).toInt(&framesOk);
+    qreal step = parser.value(stepOption).toDouble(&stepOk);
+    QStringList dimensions = parser.value(sizeOption).split('x');
+    QSize size = dimensions.length() == 2 ? QSize(dimensions[0].toInt(), dimensions[1].toInt()) : QSize();
+    if(!framesOk || frames < 0 || !stepOk || !size.isValid() || size.isEmpty()){
+        err << app.tr("Invalid frame count, step or size.") << endl;
+        return 1;
+    }
+
+    Renderer renderer(QFileInfo(file).absoluteFilePath(), QTextStream(&file).readAll());
+    QObject::connect(&renderer, &Renderer::errored, [&err](QString error, int line){
+        err << QApplication::tr("Line %1: %2").arg(line).arg(error) << endl;
+    });
+
+    return renderer.exportFrames(size, frames, step, parser.value(outputOption)) ? 0 : 1;
+}
+
 /**
  * @brief main
  * @param argc
@@ -18,6 +69,17 @@ static const QString socketName = "VeTo";
  * The main class. Sets up the application and returns its' return code.
  */
 int main(int argc, char *argv[]){
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+#endif
+
+    for(int i = 1; i < argc; ++i){
+        if(QString(argv[i]).startsWith("--render")){
+            QApplication a(argc, argv);
+            return renderHeadless(a);
+        }
+    }
+
     QLocalSocket socket;
     socket.connectToServer(socketName);
     if(socket.waitForConnected(600)){
@@ -0,0 +1,104 @@
+#ifndef AUDIOCONVERTERTEST
+#define AUDIOCONVERTERTEST
+
+#include <QTest>
+#include "../src/AudioConverter.hpp"
+
+/**
+ * @brief The AudioConverter Testing class
+ *
+ * Tests the AudioConverter class; functionality tested
+ * includes format validation, conversion of the integer
+ * and float formats and channel mapping.
+ */
+class AudioConverterTest : public QObject{
+Q_OBJECT
+private:
+    static QAudioFormat format(QAudioFormat::SampleType type, int size, int channels){
+        QAudioFormat format;
+        format.setCodec("audio/pcm");
+        format.setSampleType(type);
+        format.setSampleSize(size);
+        format.setChannelCount(channels);
+        format.setByteOrder(QSysInfo::ByteOrder == QSysInfo::LittleEndian ?
+                                QAudioFormat::LittleEndian : QAudioFormat::BigEndian);
+        return format;
+    }
+private slots:
+    void validityTest(){
+        QVERIFY(AudioConverter(format(QAudioFormat::SignedInt, 16, 2)).isValid());
+        QVERIFY(AudioConverter(format(QAudioFormat::Float, 32, 1)).isValid());
+        QVERIFY(!AudioConverter(format(QAudioFormat::Float, 16, 2)).isValid());
+        QVERIFY(!AudioConverter(format(QAudioFormat::Unknown, 16, 2)).isValid());
+        QCOMPARE(AudioConverter(format(QAudioFormat::SignedInt, 16, 2)).frameSize(), 4);
+    }
+    void int16Test(){
+        AudioConverter converter(format(QAudioFormat::SignedInt, 16, 2));
+        qint16 source[20];
+        for(int i = 0; i < 20; ++i)
+            source[i] = qint16(i * 3000 - 32768);
+        float target[20];
+        QCOMPARE(converter.convert(reinterpret_cast<const char*>(source), 10, target), 10);
+        for(int i = 0; i < 20; ++i)
+            QCOMPARE(target[i], source[i] / 32768.f);
+    }
+    void unsigned8Test(){
+        AudioConverter converter(format(QAudioFormat::UnSignedInt, 8, 2));
+        uchar source[34];
+        for(int i = 0; i < 34; ++i)
+            source[i] = uchar(i * 7);
+        float target[34];
+        converter.convert(reinterpret_cast<const char*>(source), 17, target);
+        for(int i = 0; i < 34; ++i)
+            QCOMPARE(target[i], (source[i] - 128) / 128.f);
+    }
+    void int32Test(){
+        AudioConverter converter(format(QAudioFormat::SignedInt, 32, 2));
+        qint32 source[6] = {0, 1 << 30, -(1 << 30), 0x7fffffff, -0x7fffffff - 1, 12345678};
+        float target[6];
+        converter.convert(reinterpret_cast<const char*>(source), 3, target);
+        for(int i = 0; i < 6; ++i)
+            QCOMPARE(target[i], float(source[i] / 2147483648.0));
+    }
+    void floatTest(){
+        AudioConverter converter(format(QAudioFormat::Float, 32, 2));
+        float source[4] = {-1.f, .25f, .5f, 1.f};
+        float target[4];
+        converter.convert(reinterpret_cast<const char*>(source), 2, target);
+        for(int i = 0; i < 4; ++i)
+            QCOMPARE(target[i], source[i]);
+    }
+    void monoTest(){
+        AudioConverter converter(format(QAudioFormat::SignedInt, 16, 1));
+        qint16 source[9] = {0, 16384, -16384, 8192, -8192, 1, -1, 32767, -32768};
+        float target[18];
+        QCOMPARE(converter.convert(reinterpret_cast<const char*>(source), 9, target), 9);
+        for(int i = 0; i < 9; ++i){
+            QCOMPARE(target[2*i], source[i] / 32768.f);
+            QCOMPARE(target[2*i+1], source[i] / 32768.f);
+        }
+    }
+    void surroundTest(){
+        AudioConverter converter(format(QAudioFormat::SignedInt, 16, 4));
+        qint16 source[8] = {100, 200, 300, 400, 500, 600, 700, 800};
+        float target[4];
+        converter.convert(reinterpret_cast<const char*>(source), 2, target);
+        QCOMPARE(target[0], 100 / 32768.f);
+        QCOMPARE(target[1], 200 / 32768.f);
+        QCOMPARE(target[2], 500 / 32768.f);
+        QCOMPARE(target[3], 600 / 32768.f);
+    }
+    void byteOrderTest(){
+        QAudioFormat swapped = format(QAudioFormat::SignedInt, 16, 2);
+        swapped.setByteOrder(swapped.byteOrder() == QAudioFormat::LittleEndian ?
+                                 QAudioFormat::BigEndian : QAudioFormat::LittleEndian);
+        AudioConverter converter(swapped);
+        qint16 source[2] = {qbswap(qint16(256)), qbswap(qint16(-512))};
+        float target[2];
+        converter.convert(reinterpret_cast<const char*>(source), 1, target);
+        QCOMPARE(target[0], 256 / 32768.f);
+        QCOMPARE(target[1], -512 / 32768.f);
+    }
+};
+
+#endif // AUDIOCONVERTERTEST
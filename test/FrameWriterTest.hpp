@@ -0,0 +1,104 @@
+#ifndef FRAMEWRITERTEST
+#define FRAMEWRITERTEST
+
+#include <QTest>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include "../src/FrameWriter.hpp"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+/**
+ * @brief The FrameWriter Testing class
+ *
+ * Tests the FrameWriter class; functionality tested
+ * includes choosing the format, the Y4M header, flipping
+ * and converting frames, writing a stream to disk and
+ * closing a named pipe nobody reads.
+ */
+class FrameWriterTest : public QObject{
+Q_OBJECT
+private slots:
+    void formatTest(){
+        QCOMPARE(FrameWriter::formatFor("video.y4m"), FrameWriter::Y4M);
+        QCOMPARE(FrameWriter::formatFor("VIDEO.Y4M"), FrameWriter::Y4M);
+        QCOMPARE(FrameWriter::formatFor("frames.raw"), FrameWriter::Raw);
+        QCOMPARE(FrameWriter::formatFor("/tmp/pipe"), FrameWriter::Raw);
+    }
+    void headerTest(){
+        QCOMPARE(FrameWriter::header(FrameWriter::Y4M, QSize(640, 360), 30),
+                 QByteArray("YUV4MPEG2 W640 H360 F30:1 Ip A1:1 C444\n"));
+        QVERIFY(FrameWriter::header(FrameWriter::Raw, QSize(640, 360), 30).isEmpty());
+        QCOMPARE(FrameWriter::encodedSize(FrameWriter::Raw, QSize(4, 2)), 32);
+        QCOMPARE(FrameWriter::encodedSize(FrameWriter::Y4M, QSize(4, 2)), 6 + 24);
+    }
+    void rawTest(){
+        // bottom-up rows: the first row in memory is the bottom one
+        const uchar rgba[] = {1,2,3,4, 5,6,7,8};
+        uchar raw[8];
+        FrameWriter::encode(FrameWriter::Raw, QSize(1, 2), rgba, raw);
+        const uchar flipped[] = {5,6,7,8, 1,2,3,4};
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(raw), 8),
+                 QByteArray(reinterpret_cast<const char*>(flipped), 8));
+    }
+    void y4mTest(){
+        const uchar rgba[] = {0,0,0,255, 255,255,255,255, 255,0,0,255};
+        uchar frame[6 + 9];
+        FrameWriter::encode(FrameWriter::Y4M, QSize(3, 1), rgba, frame);
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(frame), 6), QByteArray("FRAME\n"));
+        const uchar *luma = frame + 6, *blue = luma + 3, *red = blue + 3;
+        QCOMPARE(int(luma[0]), 16);
+        QCOMPARE(int(luma[1]), 235);
+        QCOMPARE(int(blue[0]), 128);
+        QCOMPARE(int(blue[1]), 128);
+        QCOMPARE(int(red[1]), 128);
+        QCOMPARE(int(red[2]), 240);
+    }
+    void writeTest(){
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.path() + "/video.y4m";
+        const QSize size(2, 2);
+
+        FrameWriter writer;
+        writer.open(path, size, 25);
+        QVERIFY(writer.isOpen());
+        for(int i = 0; i < 3; ++i){
+            QByteArray frame = writer.takeBuffer();
+            QCOMPARE(frame.size(), 16);
+            frame.fill(char(i));
+            writer.push(frame);
+        }
+        writer.close();
+        QVERIFY(!writer.isOpen());
+
+        QFile file(path);
+        QVERIFY(file.open(QFile::ReadOnly));
+        const QByteArray header = FrameWriter::header(FrameWriter::Y4M, size, 25);
+        QCOMPARE(file.size(), qint64(header.size() + 3 * FrameWriter::encodedSize(FrameWriter::Y4M, size)));
+        QVERIFY(file.readAll().startsWith(header));
+    }
+    void fifoTest(){
+#ifdef Q_OS_UNIX
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString path = dir.path() + "/pipe";
+        QCOMPARE(::mkfifo(QFile::encodeName(path).constData(), 0600), 0);
+
+        FrameWriter writer;
+        writer.open(path, QSize(2, 2), 25);
+        writer.push(writer.takeBuffer());
+        QElapsedTimer timer;
+        timer.start();
+        writer.close();
+        QVERIFY(!writer.isOpen());
+        QVERIFY(timer.elapsed() < FrameWriter::closeTimeout);
+#else
+        QSKIP("Named pipes need a Unix system");
+#endif
+    }
+};
+
+#endif // FRAMEWRITERTEST
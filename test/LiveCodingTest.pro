@@ -3,7 +3,7 @@ isEqual(QT_MAJOR_VERSION, 4) || isEqual(QT_MINOR_VERSION, 1) {
     error("Use at least Qt 5.2.")
 }
 
-QT       += core gui multimedia testlib widgets
+QT       += core gui multimedia concurrent testlib widgets
 
 TARGET = VetoLCTest
 TEMPLATE = app
@@ -64,6 +64,10 @@ HEADERS += \
     ../src/SettingsBackend.hpp \
     AudioInputProcessorTest.hpp \
     ../src/AudioInputProcessor.hpp \
+    AudioConverterTest.hpp \
+    ../src/AudioConverter.hpp \
+    SpectrumAnalyzerTest.hpp \
+    ../src/SpectrumAnalyzer.hpp \
     RendererTest.hpp \
     ../src/Instances/WindowInstance.hpp \
     AudioOutputProcessorTest.hpp \
@@ -72,6 +76,28 @@ HEADERS += \
     ../src/SettingsWindow.hpp \
     ../src/SettingsTab.hpp \
     ../src/Renderer.hpp \
+    ../src/RenderWindow.hpp \
+    ResolutionControllerTest.hpp \
+    ../src/ResolutionController.hpp \
+    TimingWindowTest.hpp \
+    ../src/TimingWindow.hpp \
+    TimelineTest.hpp \
+    ../src/Timeline.hpp \
+    FrameWriterTest.hpp \
+    ../src/FrameWriter.hpp \
+    ShaderWatchdogTest.hpp \
+    ../src/ShaderWatchdog.hpp \
+    ShaderParameterTest.hpp \
+    ../src/ShaderParameter.hpp \
+    ShaderLiteralsTest.hpp \
+    ../src/ShaderLiterals.hpp \
+    ShaderCompilerTest.hpp \
+    ../src/GpuTimer.hpp \
+    ../src/TextureCache.hpp \
+    ../src/SharedResources.hpp \
+    ../src/ProgramBinaryCache.hpp \
+    ../src/ShaderCompiler.hpp \
+    ../src/FrameStatistics.hpp \
     ../src/CodeHighlighter.hpp \
     ../src/LiveThread.hpp \
     ../src/BootLoader.hpp \
@@ -86,9 +112,24 @@ SOURCES += \
     ../src/SettingsWindow.cpp \
     ../src/SettingsTab.cpp \
     ../src/Renderer.cpp \
+    ../src/RenderWindow.cpp \
+    ../src/ResolutionController.cpp \
+    ../src/TimingWindow.cpp \
+    ../src/Timeline.cpp \
+    ../src/FrameWriter.cpp \
+    ../src/ShaderWatchdog.cpp \
+    ../src/ShaderParameter.cpp \
+    ../src/ShaderLiterals.cpp \
+    ../src/GpuTimer.cpp \
+    ../src/TextureCache.cpp \
+    ../src/SharedResources.cpp \
+    ../src/ProgramBinaryCache.cpp \
+    ../src/ShaderCompiler.cpp \
     ../src/Backend.cpp \
     ../src/SettingsBackend.cpp \
     ../src/AudioInputProcessor.cpp \
+    ../src/AudioConverter.cpp \
+    ../src/SpectrumAnalyzer.cpp \
     ../src/BootLoader.cpp \
     ../src/Instances/WindowInstance.cpp \
     ../src/AudioOutputProcessor.cpp
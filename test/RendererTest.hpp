@@ -30,7 +30,8 @@ private slots:
         thread->initialize("Test", "This is not valid code;");
         thread->start();
         QTest::qWait(1000);
-        thread->terminate();
+        thread->stop();
+        thread->wait();
     }
     void commandTest(){
         connect(thread, SIGNAL(errorSignal(GlLiveThread*, QString, int)),
@@ -40,7 +41,8 @@ private slots:
         thread->initialize("Test", "#version 330 core");
         thread->start();
         QTest::qWait(1000);
-        thread->terminate();
+        thread->stop();
+        thread->wait();
     }
     void finishedTest(GlLiveThread* returnedThread, QString returned, int lineno){
         QVERIFY(returnedThread == thread);
@@ -0,0 +1,75 @@
+#ifndef RESOLUTIONCONTROLLERTEST
+#define RESOLUTIONCONTROLLERTEST
+
+#include <QTest>
+#include "../src/ResolutionController.hpp"
+
+/**
+ * @brief The ResolutionController Testing class
+ *
+ * Tests the ResolutionController class; functionality tested
+ * includes fixed scales, scaling down on missed frames,
+ * recovering on calm frames and the scaled sizes.
+ */
+class ResolutionControllerTest : public QObject{
+Q_OBJECT
+private:
+    static bool addWindow(ResolutionController &controller, qreal frameTime){
+        bool changed = false;
+        for(int i = 0; i < ResolutionController::windowFrames; ++i)
+            changed = controller.addFrame(frameTime) || changed;
+        return changed;
+    }
+private slots:
+    void fixedScaleTest(){
+        ResolutionController controller;
+        QVERIFY(controller.isAutomatic());
+        QCOMPARE(controller.scale(), qreal(1));
+        controller.setFixedScale(0.5);
+        QVERIFY(!controller.isAutomatic());
+        QCOMPARE(controller.scale(), qreal(0.5));
+        QVERIFY(!addWindow(controller, 100));
+        QCOMPARE(controller.scale(), qreal(0.5));
+        controller.setFixedScale(0.01);
+        QCOMPARE(controller.scale(), ResolutionController::minimumScale);
+        controller.setFixedScale(0);
+        QVERIFY(controller.isAutomatic());
+    }
+    void scaleDownTest(){
+        ResolutionController controller;
+        controller.setTarget(10);
+        QVERIFY(!addWindow(controller, 10));
+        QCOMPARE(controller.scale(), qreal(1));
+        // four times the time needs half the resolution
+        QVERIFY(addWindow(controller, 40));
+        QVERIFY(qAbs(controller.scale() - 0.5) < 1e-9);
+        for(int i = 0; i < 10; ++i)
+            addWindow(controller, 1000);
+        QCOMPARE(controller.scale(), ResolutionController::minimumScale);
+    }
+    void recoverTest(){
+        ResolutionController controller;
+        controller.setTarget(10);
+        addWindow(controller, 40);
+        qreal scaled = controller.scale();
+        for(int i = 1; i < ResolutionController::calmWindows; ++i)
+            QVERIFY(!addWindow(controller, 10));
+        QVERIFY(addWindow(controller, 10));
+        QVERIFY(qAbs(controller.scale() - scaled - ResolutionController::scaleStep) < 1e-9);
+        // a slightly late window restarts the calm period
+        for(int i = 1; i < ResolutionController::calmWindows; ++i)
+            addWindow(controller, 10);
+        addWindow(controller, 11);
+        QVERIFY(!addWindow(controller, 10));
+    }
+    void sizeTest(){
+        ResolutionController controller;
+        QCOMPARE(controller.scaledSize(QSize(3840, 2160)), QSize(3840, 2160));
+        controller.setFixedScale(0.5);
+        QCOMPARE(controller.scaledSize(QSize(3840, 2160)), QSize(1920, 1080));
+        controller.setFixedScale(0.25);
+        QCOMPARE(controller.scaledSize(QSize(2, 1)), QSize(1, 1));
+    }
+};
+
+#endif // RESOLUTIONCONTROLLERTEST
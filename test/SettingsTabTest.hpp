@@ -55,4 +55,21 @@ private:
     BehaviourTab *behaviourTab;
 };
 
+class RenderTabTest : public QObject{
+Q_OBJECT
+private slots:
+    void initTestCase() {
+        renderTab = new RenderTab(&settings);
+    }
+    void objectCreationTest() {
+        QVERIFY(renderTab);
+    }
+    void cleanupTestCase() {
+        delete renderTab;
+    }
+private:
+    QHash<QString, QVariant> settings;
+    RenderTab *renderTab;
+};
+
 #endif // SETTINGSTABTEST
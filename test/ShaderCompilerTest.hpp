@@ -0,0 +1,259 @@
+#ifndef SHADERCOMPILERTEST
+#define SHADERCOMPILERTEST
+
+#include <QTest>
+#include <QScopedPointer>
+#include <QSignalSpy>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include "../src/ShaderCompiler.hpp"
+#include "../src/Renderer.hpp"
+
+/**
+ * @brief The ShaderCompiler Testing class
+ *
+ * Tests the ShaderCompiler class; functionality tested
+ * includes splitting the source into passes, parsing
+ * #vertex, #buffer and #compute directives, rejecting
+ * invalid directives and compiling code again after
+ * forgetLastCode.
+ */
+class ShaderCompilerTest : public QObject{
+Q_OBJECT
+private slots:
+    void passTest(){
+        const QString code =
+                "#version 330 core\n"
+                "uniform float gain;\n"
+                "#pass first\n"
+                "out vec4 color;\n"
+                "void main(){ color = vec4(gain); }\n"
+                "#pass second // reads first\n"
+                "out vec4 color;\n"
+                "void main(){ color = texture(first, vec2(0)); }\n";
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        QVERIFY(shader->error.isEmpty());
+        QCOMPARE(shader->passes.size(), 2);
+        QCOMPARE(shader->passes[0].name, QString("first"));
+        QCOMPARE(shader->passes[1].name, QString("second"));
+        for(const ShaderPass &pass : shader->passes){
+            QVERIFY(pass.source.startsWith("#version 330 core\n"));
+            QVERIFY(pass.source.contains("uniform float gain;"));
+            QVERIFY(pass.source.contains("uniform sampler2D first; uniform sampler2D second; uniform sampler2D backbuffer;"));
+        }
+        // the code of each pass stays on its line
+        const QString &first = shader->passes[0].source, &second = shader->passes[1].source;
+        QVERIFY(!first.contains("texture(first"));
+        QCOMPARE(first.left(first.indexOf("void main(){ color = vec4(gain); }")).count('\n'), 4);
+        QVERIFY(!second.contains("color = vec4(gain);"));
+        QCOMPARE(second.left(second.indexOf("void main(){ color = texture(first")).count('\n'), 7);
+    }
+    void singlePassTest(){
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess(
+                "", "#version 330 core\nout vec4 color;\nvoid main(){ color = vec4(1); }\n", images));
+        QVERIFY(shader->error.isEmpty());
+        QCOMPARE(shader->passes.size(), 1);
+        QVERIFY(shader->passes[0].name.isEmpty());
+        QVERIFY(!shader->passes[0].source.contains("backbuffer"));
+    }
+    void passNameTest(){
+        const QString common = "#version 330 core\nout vec4 color;\n";
+        QCOMPARE(errorOf(common + "#pass a\nvoid main(){}\n#pass a\nvoid main(){}\n"), QString("Invalid pass name: a"));
+        QCOMPARE(errorLineOf(common + "#pass a\nvoid main(){}\n#pass a\nvoid main(){}\n"), 4);
+        QCOMPARE(errorOf(common + "#pass\nvoid main(){}\n"), QString("Missing pass name"));
+        QCOMPARE(errorOf(common + "#pass   \nvoid main(){}\n"), QString("Missing pass name"));
+        QCOMPARE(errorOf(common + "#pass backbuffer\nvoid main(){}\n"), QString("Invalid pass name: backbuffer"));
+        QCOMPARE(errorOf(common + "#pass 1st\nvoid main(){}\n"), QString("Invalid pass name: 1st"));
+        QVERIFY(errorOf(common + "#pass a\nvoid main(){}\n#pass b\nvoid main(){}\n").isEmpty());
+    }
+    void vertexTest(){
+        const QString code =
+                "#version 330 core\n"
+                "uniform float gain;\n"
+                "#vertex 1000 lines additive\n"
+                "void main(){ gl_Position = vec4(gl_VertexID, 0, 0, 1); vertexColor = vec4(gain); }\n";
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        QVERIFY(shader->error.isEmpty());
+        const ShaderPass &pass = shader->passes[0];
+        QCOMPARE(pass.vertexCount, 1000);
+        QCOMPARE(pass.primitive, GLenum(GL_LINES));
+        QCOMPARE(pass.blending, ShaderPass::Additive);
+        QVERIFY(pass.vertexSource.contains("uniform float gain;"));
+        QVERIFY(pass.vertexSource.contains("const int vertexCount = 1000;"));
+        QVERIFY(pass.vertexSource.contains("gl_Position = vec4(gl_VertexID, 0, 0, 1);"));
+        // without #fragment the primitives are filled with vertexColor
+        QVERIFY(!pass.source.contains("gl_Position"));
+        QVERIFY(pass.source.contains("layout(location = 0) out vec4 vertexFragmentColor;"));
+    }
+    void vertexDefaultsTest(){
+        const QString code =
+                "#version 330 core\n"
+                "#vertex 10\n"
+                "void main(){ gl_Position = vec4(0, 0, 0, 1); }\n"
+                "#fragment\n"
+                "out vec4 color;\n"
+                "void main(){ color = vertexColor; }\n";
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        QVERIFY(shader->error.isEmpty());
+        const ShaderPass &pass = shader->passes[0];
+        QCOMPARE(pass.vertexCount, 10);
+        QCOMPARE(pass.primitive, GLenum(GL_POINTS));
+        QCOMPARE(pass.blending, ShaderPass::Opaque);
+        QVERIFY(!pass.vertexSource.contains("color = vertexColor;"));
+        QVERIFY(pass.source.contains("color = vertexColor;"));
+        QVERIFY(!pass.source.contains("vertexFragmentColor"));
+        QCOMPARE(pass.source.left(pass.source.indexOf("void main(){ color")).count('\n'), 5);
+
+        QScopedPointer<CompiledShader> alpha(ShaderCompiler::preprocess(
+                "", "#version 330 core\n#vertex 3 alpha triangles\nvoid main(){}\n", images));
+        QVERIFY(alpha->error.isEmpty());
+        QCOMPARE(alpha->passes[0].primitive, GLenum(GL_TRIANGLES));
+        QCOMPARE(alpha->passes[0].blending, ShaderPass::AlphaBlending);
+    }
+    void vertexErrorTest(){
+        const QString common = "#version 330 core\nout vec4 color;\n";
+        const QString maximum = QString::number(ShaderCompiler::maximumVertexCount);
+        const QString tooMany = QString::number(ShaderCompiler::maximumVertexCount + 1);
+        QVERIFY(errorOf(common + "#vertex " + maximum + "\nvoid main(){}\n").isEmpty());
+        QVERIFY(errorOf(common + "#vertex " + tooMany + "\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QCOMPARE(errorLineOf(common + "#vertex " + tooMany + "\nvoid main(){}\n"), 2);
+        QVERIFY(errorOf(common + "#vertex 0\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#vertex\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#vertex many\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#vertex 10 squares\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#vertex 10 points opaque more\nvoid main(){}\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#vertex 10\nvoid main(){}\n#vertex 10\n").contains("Invalid #vertex directive"));
+        QVERIFY(errorOf(common + "#pass a\n#vertex 0\nvoid main(){}\n").startsWith("Pass a: "));
+    }
+    void computeTest(){
+        const QString code =
+                "#version 430\n"
+                "#buffer particles 1000 vec4\n"
+                "#buffer speeds 20 float\n"
+                "#pass move\n"
+                "#compute 4 2\n"
+                "layout(local_size_x = 64) in;\n"
+                "void main(){ particles[gl_GlobalInvocationID.x] += vec4(speeds[0]); }\n"
+                "#pass image\n"
+                "out vec4 color;\n"
+                "void main(){ color = particles[0]; }\n";
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        QVERIFY(shader->error.isEmpty());
+        QCOMPARE(shader->storageBuffers.size(), 2);
+        QCOMPARE(shader->storageBuffers[0], qMakePair(QString("particles"), 1000));
+        QCOMPARE(shader->storageBuffers[1], qMakePair(QString("speeds"), 20));
+        for(const ShaderPass &pass : shader->passes){
+            QVERIFY(pass.source.contains("layout(std430, binding = 0) buffer particlesBuffer{ vec4 particles[]; };"));
+            QVERIFY(pass.source.contains("layout(std430, binding = 1) buffer speedsBuffer{ float speeds[]; };"));
+        }
+
+        const ShaderPass &move = shader->passes[0];
+        QCOMPARE(move.computeGroups[0], 4);
+        QCOMPARE(move.computeGroups[1], 2);
+        QCOMPARE(move.computeGroups[2], 1);
+        QVERIFY(!move.source.contains("#compute"));
+        QCOMPARE(move.source.left(move.source.indexOf("layout(local_size_x")).count('\n'), 5);
+        QCOMPARE(shader->passes[1].computeGroups[0], 0);
+    }
+    void bufferErrorTest(){
+        const QString common = "#version 430\nout vec4 color;\n";
+        const QString body = "void main(){}\n";
+        QVERIFY(errorOf(common + "#buffer a " + QString::number(ShaderCompiler::maximumVertexCount) + " float\n" + body).isEmpty());
+        QVERIFY(errorOf(common + "#buffer a " + QString::number(ShaderCompiler::maximumVertexCount + 1) + " float\n" + body)
+                .startsWith("Invalid #buffer directive"));
+        QCOMPARE(errorLineOf(common + "#buffer a 0 float\n" + body), 2);
+        QVERIFY(errorOf(common + "#buffer a 0 float\n" + body).startsWith("Invalid #buffer directive"));
+        QVERIFY(errorOf(common + "#buffer a ten float\n" + body).startsWith("Invalid #buffer directive"));
+        QVERIFY(errorOf(common + "#buffer a 10\n" + body).startsWith("Invalid #buffer directive"));
+        QVERIFY(errorOf(common + "#buffer 10 float\n" + body).startsWith("Invalid #buffer directive"));
+        QVERIFY(errorOf(common + "#buffer a 10 float\n#buffer a 10 float\n" + body).startsWith("Invalid #buffer directive"));
+
+        QString buffers;
+        for(int i = 0; i < ShaderCompiler::maximumStorageBuffers; ++i)
+            buffers += QString("#buffer b%1 10 float\n").arg(i);
+        QVERIFY(errorOf(common + buffers + body).isEmpty());
+        QVERIFY(errorOf(common + buffers + "#buffer c 10 float\n" + body).startsWith("Invalid #buffer directive"));
+        QCOMPARE(errorLineOf(common + buffers + "#buffer c 10 float\n" + body), 2 + ShaderCompiler::maximumStorageBuffers);
+    }
+    void computeErrorTest(){
+        const QString common = "#version 430\n#buffer a 10 float\n";
+        const QString image = "#pass image\nout vec4 color;\nvoid main(){}\n";
+        const QString maximum = QString::number(ShaderCompiler::maximumComputeGroups);
+        const QString tooMany = QString::number(ShaderCompiler::maximumComputeGroups + 1);
+        QVERIFY(errorOf(common + "#pass step\n#compute " + maximum + " 1 " + maximum + "\nvoid main(){}\n" + image).isEmpty());
+        QVERIFY(errorOf(common + "#pass step\n#compute " + tooMany + "\nvoid main(){}\n" + image)
+                .startsWith("Invalid #compute directive"));
+        QCOMPARE(errorLineOf(common + "#pass step\n#compute 0\nvoid main(){}\n" + image), 3);
+        QVERIFY(errorOf(common + "#pass step\n#compute 0\nvoid main(){}\n" + image).startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + "#pass step\n#compute\nvoid main(){}\n" + image).startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + "#pass step\n#compute 1 2 3 4\nvoid main(){}\n" + image).startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + "#pass step\n#compute x\nvoid main(){}\n" + image).startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + "#pass step\n#compute 1\n#compute 1\nvoid main(){}\n" + image)
+                .startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + "#pass step\n#compute 1\n#vertex 10\nvoid main(){}\n" + image)
+                .startsWith("Invalid #compute directive"));
+        // only named passes can be compute passes, and not the last one
+        QVERIFY(errorOf(common + "#compute 1\nvoid main(){}\n").startsWith("Invalid #compute directive"));
+        QVERIFY(errorOf(common + image + "#pass step\n#compute 1\nvoid main(){}\n").startsWith("The last pass"));
+    }
+    void forgetLastCodeTest(){
+        QOffscreenSurface surface;
+        surface.setFormat(Renderer::surfaceFormat());
+        surface.create();
+        QOpenGLContext context;
+        context.setFormat(Renderer::surfaceFormat());
+        if(!context.create())
+            QSKIP("No OpenGL context available");
+
+        ShaderCompiler compiler;
+        QVERIFY(compiler.createContext(&context));
+        QSignalSpy compiled(&compiler, SIGNAL(compiled()));
+        const QString code = "#version 330 core\nout vec4 color;\nvoid main(){ color = vec4(1.0); }\n";
+
+        compiler.queueCode("", code);
+        QVERIFY(compiled.wait(5000));
+        QList<CompiledShader*> results = compiler.takeResults();
+        QCOMPARE(results.size(), 1);
+        QVERIFY(results.first()->error.isEmpty());
+        context.makeCurrent(&surface);
+        qDeleteAll(results);
+        context.doneCurrent();
+
+        // the same code is ignored while it is shown
+        compiler.queueCode("", code);
+        QVERIFY(!compiled.wait(500));
+        QVERIFY(compiler.takeResults().isEmpty());
+
+        // Renderer::fallBack forgets it when the watchdog drops the program
+        compiler.forgetLastCode();
+        compiler.queueCode("", code);
+        QVERIFY(compiled.wait(5000));
+        results = compiler.takeResults();
+        QCOMPARE(results.size(), 1);
+        QVERIFY(results.first()->error.isEmpty());
+        context.makeCurrent(&surface);
+        qDeleteAll(results);
+        context.doneCurrent();
+
+        compiler.release();
+    }
+
+private:
+    QString errorOf(const QString &code){
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        return shader->error;
+    }
+    int errorLineOf(const QString &code){
+        ShaderCompiler::ImageList images;
+        QScopedPointer<CompiledShader> shader(ShaderCompiler::preprocess("", code, images));
+        return shader->errorLine;
+    }
+};
+
+#endif // SHADERCOMPILERTEST
@@ -0,0 +1,66 @@
+#ifndef SHADERLITERALSTEST
+#define SHADERLITERALSTEST
+
+#include <QTest>
+#include "../src/ShaderLiterals.hpp"
+
+/**
+ * @brief The ShaderLiterals Testing class
+ *
+ * Tests the ShaderLiterals class; functionality tested
+ * includes which literals are hoisted, that edits of literals
+ * hoist to the same code and declaring the array.
+ */
+class ShaderLiteralsTest : public QObject{
+Q_OBJECT
+private slots:
+    void hoistTest(){
+        const QString source =
+                "#version 330 core\n"
+                "#define SCALE 2.0\n"
+                "const float pi = 3.14;\n"
+                "out vec4 color;\n"
+                "void main(){\n"
+                "    const float h = .5; // 1.5\n"
+                "    vec2 p = vec2(1.0, 2e1) * 4 /* 0.25 */;\n"
+                "    color = vec4(p, 0x1F, 1.f);\n"
+                "}\n";
+        QVector<float> values;
+        const QString hoisted = ShaderLiterals::hoist(source, values);
+        QCOMPARE(values, QVector<float>() << 1.f << 20.f << 1.f);
+        QVERIFY(hoisted.contains("vec2(vetoLiterals[0].x, vetoLiterals[0].y) * 4 /* 0.25 */;"));
+        QVERIFY(hoisted.contains("vec4(p, 0x1F, vetoLiterals[0].z)"));
+        QVERIFY(hoisted.contains("#define SCALE 2.0"));
+        QVERIFY(hoisted.contains("const float pi = 3.14;"));
+        QVERIFY(hoisted.contains("const float h = .5; // 1.5"));
+        QCOMPARE(hoisted.count('\n'), source.count('\n'));
+    }
+    void editTest(){
+        QVector<float> before, after;
+        const QString hoisted = ShaderLiterals::hoist("void main(){ color = vec4(0.5, 1.0, 0.0, 1.0); }", before);
+        QCOMPARE(ShaderLiterals::hoist("void main(){ color = vec4(0.75, 1.0, 0.0, 1.0); }", after), hoisted);
+        QCOMPARE(after[0], .75f);
+        QVERIFY(ShaderLiterals::hoist("void main(){ color = vec4(0.75, 1.0, 0.0, 1); }", after) != hoisted);
+    }
+    void limitTest(){
+        QString source = "void main(){";
+        for(int i = 0; i <= ShaderLiterals::maximumLiterals; ++i)
+            source += " x += 1.0;";
+        source += " }";
+        QVector<float> values;
+        const QString hoisted = ShaderLiterals::hoist(source, values);
+        QCOMPARE(values.size(), ShaderLiterals::maximumLiterals);
+        QCOMPARE(hoisted.count("1.0"), 1);
+    }
+    void declareTest(){
+        QString source = "#version 330 core\n#extension GL_ARB_foo : enable\nout vec4 color;\n";
+        QVERIFY(ShaderLiterals::declare(source, 5));
+        QCOMPARE(source, QString("#version 330 core\n#extension GL_ARB_foo : enable\n"
+                                 "uniform vec4 vetoLiterals[2]; out vec4 color;\n"));
+        QString empty = "void main(){}";
+        QVERIFY(!ShaderLiterals::declare(empty, 0));
+        QCOMPARE(ShaderLiterals::pack(QVector<float>() << 1 << 2).size(), 4);
+    }
+};
+
+#endif // SHADERLITERALSTEST
@@ -0,0 +1,62 @@
+#ifndef SHADERPARAMETERTEST
+#define SHADERPARAMETERTEST
+
+#include <QTest>
+#include "../src/ShaderParameter.hpp"
+
+/**
+ * @brief The ShaderParameter Testing class
+ *
+ * Tests the ShaderParameter class; functionality tested
+ * includes parsing annotated uniforms, defaults and clamping.
+ */
+class ShaderParameterTest : public QObject{
+Q_OBJECT
+private slots:
+    void parseTest(){
+        const QString source =
+                "#version 330 core\n"
+                "uniform float speed; // @range 0 10 @default 2\n"
+                "uniform int steps;   // how many @range 1 64\n"
+                "uniform float plain;\n"
+                "uniform float noted; // just a comment\n"
+                "uniform vec2 offset; // @range 0 1\n";
+        QList<ShaderParameter> parameters = ShaderParameter::parse(source);
+        QCOMPARE(parameters.size(), 2);
+
+        QCOMPARE(parameters[0].name, QString("speed"));
+        QCOMPARE(parameters[0].type, ShaderParameter::Float);
+        QCOMPARE(parameters[0].minimum, 0.f);
+        QCOMPARE(parameters[0].maximum, 10.f);
+        QCOMPARE(parameters[0].defaultValue, 2.f);
+        QCOMPARE(parameters[0].value, 2.f);
+
+        QCOMPARE(parameters[1].name, QString("steps"));
+        QCOMPARE(parameters[1].type, ShaderParameter::Int);
+        QCOMPARE(parameters[1].defaultValue, 1.f);
+    }
+    void invalidTest(){
+        const QString source =
+                "uniform float a; // @range 1 -1\n"
+                "uniform float b; // @range -.5 1e1 @default -2\n"
+                "uniform float b; // @range 0 1\n";
+        QList<ShaderParameter> parameters = ShaderParameter::parse(source);
+        QCOMPARE(parameters.size(), 1);
+        QCOMPARE(parameters[0].name, QString("b"));
+        QCOMPARE(parameters[0].minimum, -.5f);
+        QCOMPARE(parameters[0].maximum, 10.f);
+        QCOMPARE(parameters[0].defaultValue, -.5f);
+    }
+    void clampTest(){
+        ShaderParameter parameter;
+        parameter.minimum = -1;
+        parameter.maximum = 3;
+        QCOMPARE(parameter.clamp(5), 3.f);
+        QCOMPARE(parameter.clamp(1.4f), 1.4f);
+        parameter.type = ShaderParameter::Int;
+        QCOMPARE(parameter.clamp(1.4f), 1.f);
+        QCOMPARE(parameter.clamp(-7), -1.f);
+    }
+};
+
+#endif // SHADERPARAMETERTEST
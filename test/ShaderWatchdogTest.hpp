@@ -0,0 +1,61 @@
+#ifndef SHADERWATCHDOGTEST
+#define SHADERWATCHDOGTEST
+
+#include <QTest>
+#include "../src/ShaderWatchdog.hpp"
+
+/**
+ * @brief The ShaderWatchdog Testing class
+ *
+ * Tests the ShaderWatchdog class; functionality tested
+ * includes tripping after frames over the budget, starting
+ * anew on frames within it, trusting and disabling.
+ */
+class ShaderWatchdogTest : public QObject{
+Q_OBJECT
+private slots:
+    void tripTest(){
+        ShaderWatchdog watchdog;
+        watchdog.setBudget(100);
+        watchdog.setLimit(3);
+        QVERIFY(!watchdog.addFrame(150));
+        QVERIFY(!watchdog.addFrame(300));
+        QVERIFY(watchdog.addFrame(200));
+        QCOMPARE(watchdog.worstTime(), qreal(300));
+        // counting starts anew after tripping
+        QVERIFY(!watchdog.addFrame(200));
+    }
+    void goodFrameTest(){
+        ShaderWatchdog watchdog;
+        watchdog.setBudget(100);
+        watchdog.setLimit(3);
+        QVERIFY(!watchdog.addFrame(150));
+        QVERIFY(!watchdog.addFrame(150));
+        QVERIFY(!watchdog.addFrame(50));
+        QCOMPARE(watchdog.worstTime(), qreal(0));
+        QVERIFY(!watchdog.addFrame(150));
+        QVERIFY(!watchdog.addFrame(150));
+        QVERIFY(watchdog.addFrame(150));
+    }
+    void trustTest(){
+        ShaderWatchdog watchdog;
+        watchdog.setBudget(100);
+        for(int i = 0; i < ShaderWatchdog::trustFrames - 1; ++i)
+            watchdog.addFrame(10);
+        QVERIFY(!watchdog.isTrusted());
+        watchdog.addFrame(10);
+        QVERIFY(watchdog.isTrusted());
+        watchdog.reset();
+        QVERIFY(!watchdog.isTrusted());
+    }
+    void disabledTest(){
+        ShaderWatchdog watchdog;
+        watchdog.setBudget(0);
+        watchdog.setLimit(1);
+        for(int i = 0; i < ShaderWatchdog::trustFrames; ++i)
+            QVERIFY(!watchdog.addFrame(10000));
+        QVERIFY(watchdog.isTrusted());
+    }
+};
+
+#endif // SHADERWATCHDOGTEST
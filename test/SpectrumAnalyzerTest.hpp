@@ -0,0 +1,67 @@
+#ifndef SPECTRUMANALYZERTEST
+#define SPECTRUMANALYZERTEST
+
+#include <QTest>
+#include "../src/SpectrumAnalyzer.hpp"
+
+/**
+ * @brief The SpectrumAnalyzer Testing class
+ *
+ * Tests the SpectrumAnalyzer class; functionality tested
+ * includes size planning, channel separation, magnitude
+ * scaling and smoothing.
+ */
+class SpectrumAnalyzerTest : public QObject{
+Q_OBJECT
+private:
+    static std::vector<float> sines(int size, int leftBin, float leftAmplitude,
+                                    int rightBin, float rightAmplitude){
+        std::vector<float> frames(2 * size);
+        for(int i = 0; i < size; ++i){
+            frames[2*i]   = leftAmplitude  * float(std::sin(2 * M_PI * leftBin * i / size));
+            frames[2*i+1] = rightAmplitude * float(std::cos(2 * M_PI * rightBin * i / size));
+        }
+        return frames;
+    }
+private slots:
+    void sizeTest(){
+        SpectrumAnalyzer analyzer;
+        QCOMPARE(analyzer.size(), 0);
+        QCOMPARE(analyzer.bins(), 0);
+        analyzer.setSize(1000);
+        QCOMPARE(analyzer.size(), 1024);
+        QCOMPARE(analyzer.bins(), 512);
+        analyzer.setSize(1);
+        QCOMPARE(analyzer.size(), SpectrumAnalyzer::minimumSize);
+        analyzer.setSize(1 << 20);
+        QCOMPARE(analyzer.size(), SpectrumAnalyzer::maximumSize);
+        QCOMPARE(SpectrumAnalyzer::roundSize(256), 256);
+    }
+    void peakTest(){
+        const int size = 1024;
+        SpectrumAnalyzer analyzer(size);
+        std::vector<float> frames = sines(size, 10, 0.5f, 100, 0.8f);
+        analyzer.analyze(frames.data());
+        QVERIFY(qAbs(analyzer.left()[10] - 0.5f) < 1e-3f);
+        QVERIFY(qAbs(analyzer.right()[100] - 0.8f) < 1e-3f);
+        // the Hann window leaks half of the peak into each neighbour and nothing beyond
+        QVERIFY(qAbs(analyzer.left()[11] - 0.25f) < 1e-3f);
+        QVERIFY(analyzer.left()[100] < 1e-3f);
+        QVERIFY(analyzer.right()[10] < 1e-3f);
+        QVERIFY(analyzer.left()[300] < 1e-3f);
+    }
+    void smoothingTest(){
+        const int size = 256;
+        SpectrumAnalyzer analyzer(size, 0.5f);
+        std::vector<float> frames = sines(size, 20, 1.f, 20, 1.f);
+        analyzer.analyze(frames.data());
+        QVERIFY(qAbs(analyzer.left()[20] - 0.5f) < 1e-3f);
+        analyzer.analyze(frames.data());
+        QVERIFY(qAbs(analyzer.left()[20] - 0.75f) < 1e-3f);
+        analyzer.setSmoothing(0.f);
+        analyzer.analyze(frames.data());
+        QVERIFY(qAbs(analyzer.right()[20] - 1.f) < 1e-3f);
+    }
+};
+
+#endif // SPECTRUMANALYZERTEST
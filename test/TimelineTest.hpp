@@ -0,0 +1,83 @@
+#ifndef TIMELINETEST
+#define TIMELINETEST
+
+#include <QTest>
+#include "../src/Timeline.hpp"
+
+/**
+ * @brief The Timeline Testing class
+ *
+ * Tests the Timeline class; functionality tested
+ * includes following the clock, pausing, seeking,
+ * the speed factor and fixed steps.
+ */
+class TimelineTest : public QObject{
+Q_OBJECT
+private slots:
+    void clockTest(){
+        Timeline timeline;
+        timeline.update(1000);
+        QCOMPARE(timeline.nanoseconds(), qint64(0));
+        timeline.update(16001000);
+        QCOMPARE(timeline.nanoseconds(), qint64(16000000));
+        QCOMPARE(timeline.milliseconds(), 16.0);
+    }
+    void precisionTest(){
+        Timeline timeline;
+        const qint64 day = qint64(24) * 3600 * 1000000000;
+        timeline.update(0);
+        timeline.update(3 * day);
+        timeline.update(3 * day + 1);
+        QCOMPARE(timeline.nanoseconds(), 3 * day + 1);
+    }
+    void pauseTest(){
+        Timeline timeline;
+        timeline.update(0);
+        timeline.update(1000000);
+        timeline.pause();
+        QVERIFY(timeline.isPaused());
+        timeline.update(5000000);
+        QCOMPARE(timeline.nanoseconds(), qint64(1000000));
+        timeline.togglePause();
+        QVERIFY(!timeline.isPaused());
+        // the time spent paused is skipped
+        timeline.update(9000000);
+        QCOMPARE(timeline.nanoseconds(), qint64(1000000));
+        timeline.update(10000000);
+        QCOMPARE(timeline.nanoseconds(), qint64(2000000));
+    }
+    void seekTest(){
+        Timeline timeline;
+        timeline.seek(2500);
+        QCOMPARE(timeline.milliseconds(), 2500.0);
+        timeline.seek(-10);
+        QCOMPARE(timeline.nanoseconds(), qint64(0));
+        timeline.update(0);
+        timeline.update(1000000);
+        QCOMPARE(timeline.milliseconds(), 1.0);
+    }
+    void speedTest(){
+        Timeline timeline;
+        timeline.setSpeed(0.5);
+        timeline.update(0);
+        timeline.update(10000000);
+        QCOMPARE(timeline.milliseconds(), 5.0);
+        timeline.setSpeed(-1);
+        QCOMPARE(timeline.speed(), 0.0);
+    }
+    void fixedStepTest(){
+        Timeline timeline;
+        timeline.setFixedStep(20);
+        QCOMPARE(timeline.fixedStep(), 20.0);
+        timeline.update(0);
+        // the clock does not matter in fixed steps
+        timeline.update(1);
+        timeline.update(500000000);
+        QCOMPARE(timeline.milliseconds(), 40.0);
+        timeline.setFixedStep(0);
+        timeline.update(501000000);
+        QCOMPARE(timeline.milliseconds(), 41.0);
+    }
+};
+
+#endif // TIMELINETEST
@@ -0,0 +1,51 @@
+#ifndef TIMINGWINDOWTEST
+#define TIMINGWINDOWTEST
+
+#include <QTest>
+#include "../src/TimingWindow.hpp"
+
+/**
+ * @brief The TimingWindow Testing class
+ *
+ * Tests the TimingWindow class; functionality tested
+ * includes averages, percentiles and replacing the
+ * oldest samples once the window is full.
+ */
+class TimingWindowTest : public QObject{
+Q_OBJECT
+private slots:
+    void emptyTest(){
+        TimingWindow window(10);
+        QCOMPARE(window.count(), 0);
+        QCOMPARE(window.mean(), 0.0);
+        QCOMPARE(window.percentile(0.95), 0.0);
+    }
+    void percentileTest(){
+        TimingWindow window(100);
+        for(int i = 100; i > 0; --i)
+            window.add(i);
+        QCOMPARE(window.count(), 100);
+        QCOMPARE(window.mean(), 50.5);
+        QCOMPARE(window.percentile(0.5), 50.0);
+        QCOMPARE(window.percentile(0.95), 95.0);
+        QCOMPARE(window.percentile(0.99), 99.0);
+        QCOMPARE(window.percentile(0), 1.0);
+        QCOMPARE(window.percentile(1), 100.0);
+    }
+    void rollingTest(){
+        TimingWindow window(4);
+        for(int i = 1; i <= 4; ++i)
+            window.add(100);
+        for(int i = 1; i <= 4; ++i)
+            window.add(i);
+        QCOMPARE(window.count(), 4);
+        QCOMPARE(window.mean(), 2.5);
+        QCOMPARE(window.percentile(1), 4.0);
+        window.clear();
+        QCOMPARE(window.count(), 0);
+        window.add(7);
+        QCOMPARE(window.percentile(0.5), 7.0);
+    }
+};
+
+#endif // TIMINGWINDOWTEST
@@ -1,6 +1,16 @@
 #include <QException>
 
 #include "AudioInputProcessorTest.hpp"
+#include "AudioConverterTest.hpp"
+#include "SpectrumAnalyzerTest.hpp"
+#include "ResolutionControllerTest.hpp"
+#include "TimingWindowTest.hpp"
+#include "TimelineTest.hpp"
+#include "FrameWriterTest.hpp"
+#include "ShaderWatchdogTest.hpp"
+#include "ShaderParameterTest.hpp"
+#include "ShaderLiteralsTest.hpp"
+#include "ShaderCompilerTest.hpp"
 #include "AudioOutputProcessorTest.hpp"
 #include "CodeEditorTest.hpp"
 #include "EditorWindowTest.hpp"
@@ -56,6 +66,16 @@ int main(int argc, char** argv){
             {new QString("EditorWindow"), factory<EditorWindowTest>},
             {new QString("AudioOutputProcessor"), factory<AudioOutputProcessorTest>},
             {new QString("AudioInputProcessor"), factory<AudioInputProcessorTest>},
+            {new QString("AudioConverter"), factory<AudioConverterTest>},
+            {new QString("SpectrumAnalyzer"), factory<SpectrumAnalyzerTest>},
+            {new QString("ResolutionController"), factory<ResolutionControllerTest>},
+            {new QString("TimingWindow"), factory<TimingWindowTest>},
+            {new QString("Timeline"), factory<TimelineTest>},
+            {new QString("FrameWriter"), factory<FrameWriterTest>},
+            {new QString("ShaderWatchdog"), factory<ShaderWatchdogTest>},
+            {new QString("ShaderParameter"), factory<ShaderParameterTest>},
+            {new QString("ShaderLiterals"), factory<ShaderLiteralsTest>},
+            {new QString("ShaderCompiler"), factory<ShaderCompilerTest>},
             {new QString("Backend"), factory<BackendTest>},
             {new QString("SoundGenerator"), factory<SoundGeneratorTest>},
             {new QString("SettingsBackend"), factory<SettingsBackendTest>},